@@ -195,4 +195,5 @@ private:
 
 // Register QExpected types with Qt's meta-type system
 Q_DECLARE_METATYPE(QExpected<QString>)
+Q_DECLARE_METATYPE(QExpected<QVariantList>)
 Q_DECLARE_METATYPE(QExpected<void>)
\ No newline at end of file
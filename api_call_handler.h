@@ -1,15 +1,20 @@
 #pragma once
 
 #include <QString>
+#include <atomic>
 #include <chrono>
-#include <memory>
-#include <mutex>
+#include <functional>
 #include <semaphore>
+#include <thread>
 #include <type_traits>
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "QExpected.h"
+#include "async_call_registry.h"
+#include "cancellation_token.h"
+#include "delivery_metrics.h"
+#include "pending_call_table.h"
 
 extern "C" {
 #include <liblogosdelivery.h>
@@ -31,61 +36,136 @@ auto bindApiCall(Func func, void* callbackCtx, BoundArgs&&... boundArgs)
     };
 }
 
-template <typename BoundInvoke>
-QExpected<void> callApiRetVoid(const QString& operationName, std::chrono::seconds timeout, BoundInvoke&& invoke)
-{
-    struct CallbackContext {
-        std::binary_semaphore sem{0};
-        CallbackPayload payload;
-    };
-
-    static std::mutex pendingMutex;
-    static std::unordered_map<void*, std::shared_ptr<CallbackContext>> pendingContexts;
-
-    auto callbackCtx = std::make_shared<CallbackContext>();
-    void* callbackKey = static_cast<void*>(callbackCtx.get());
+/**
+ * Waiter living on the caller's stack for the duration of one blocking call.
+ * All pending callbacks are tracked by the shared PendingCallTable; a waiter is
+ * only ever touched by a callback whose key is still current, so once the call
+ * is cancelled or completed nothing references it any more.
+ *
+ * The callback may still be inside `sem.release()` when the caller wakes up,
+ * so `done` is its last access; a caller woken by the callback must
+ * @ref awaitCallback before the waiter leaves its stack.
+ */
+struct SyncCallWaiter {
+    std::binary_semaphore sem{0};
+    std::atomic<bool> done{false};
+    CallbackPayload payload;
 
+    static void complete(void* target, int callerRet, const char* msg, size_t len)
     {
-        std::lock_guard<std::mutex> lock(pendingMutex);
-        pendingContexts[callbackKey] = callbackCtx;
+        auto* waiter = static_cast<SyncCallWaiter*>(target);
+        waiter->payload.callerRet = callerRet;
+        if (msg && len > 0) {
+            waiter->payload.message = QString::fromUtf8(msg, len);
+        }
+        waiter->sem.release();
+        waiter->done.store(true, std::memory_order_release);
     }
 
-    auto callback = +[](int callerRet, const char* msg, size_t len, void* userData) {
-        std::shared_ptr<CallbackContext> callbackCtx;
-        {
-            std::lock_guard<std::mutex> lock(pendingMutex);
-            auto it = pendingContexts.find(userData);
-            if (it == pendingContexts.end()) {
-                return;
-            }
-            callbackCtx = it->second;
-            pendingContexts.erase(it);
+    void awaitCallback() const
+    {
+        while (!done.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
         }
+    }
+};
 
-        callbackCtx->payload.callerRet = callerRet;
-        if (msg && len > 0) {
-            callbackCtx->payload.message = QString::fromUtf8(msg, len);
-        }
-        callbackCtx->sem.release();
-    };
+inline QString pendingTableFullError(const QString& operationName)
+{
+    return "failed to initiate " + operationName + ": too many pending calls";
+}
+
+inline void recordCall(FfiOperation operation, CallOutcome outcome, std::chrono::steady_clock::time_point startedAt = {})
+{
+    DeliveryMetrics::instance().recordCall(operation, outcome, std::chrono::steady_clock::now() - startedAt);
+}
+
+/**
+ * Initiates one call and blocks until its callback arrives, `timeout` expires
+ * or `cancellation` is cancelled; in the latter two cases the pending slot is
+ * reclaimed and a late callback is ignored. On success `payload` holds the
+ * callback result. Every outcome is recorded in DeliveryMetrics.
+ */
+template <typename BoundInvoke>
+QExpected<void> invokeAndWait(
+    FfiOperation operation,
+    std::chrono::milliseconds timeout,
+    BoundInvoke&& invoke,
+    CallbackPayload& payload,
+    CancellationToken* cancellation = nullptr)
+{
+    const QString& operationName = ffiOperationName(operation);
+    PendingCallTable& table = PendingCallTable::instance();
+    SyncCallWaiter waiter;
+    void* callbackKey = table.claim(&SyncCallWaiter::complete, &waiter);
+    if (!callbackKey) {
+        recordCall(operation, CallOutcome::NotInitiated);
+        return QExpected<void>::err(pendingTableFullError(operationName));
+    }
 
-    int startResult = invoke(callback, callbackKey);
+    const auto startedAt = std::chrono::steady_clock::now();
+    int startResult = invoke(&PendingCallTable::dispatch, callbackKey);
     if (startResult != RET_OK) {
-        std::lock_guard<std::mutex> lock(pendingMutex);
-        pendingContexts.erase(callbackKey);
+        if (!table.cancel(callbackKey)) {
+            // The callback fired anyway; let it finish with the waiter first
+            waiter.sem.acquire();
+            waiter.awaitCallback();
+        }
+        recordCall(operation, CallOutcome::NotInitiated);
         return QExpected<void>::err("failed to initiate " + operationName);
     }
 
-    if (!callbackCtx->sem.try_acquire_for(timeout)) {
-        std::lock_guard<std::mutex> lock(pendingMutex);
-        pendingContexts.erase(callbackKey);
-        return QExpected<void>::err(operationName + " callback timeout");
+    bool cancelled = false;
+    if (cancellation && !cancellation->attach(table, callbackKey, waiter.sem, cancelled)) {
+        if (table.cancel(callbackKey)) {
+            recordCall(operation, CallOutcome::Cancelled);
+            return QExpected<void>::err(operationName + " cancelled");
+        }
+        // Cancelled too late: the callback is already completing, take its result
+        cancellation = nullptr;
+    }
+
+    const bool woken = waiter.sem.try_acquire_for(timeout);
+    if (cancellation) {
+        cancellation->detach();
+    }
+    if (!woken) {
+        if (table.cancel(callbackKey)) {
+            recordCall(operation, CallOutcome::Timeout);
+            return QExpected<void>::err(operationName + " callback timeout");
+        }
+        // Lost the race against a callback or cancellation that is completing right now
+        waiter.sem.acquire();
+    }
+    if (cancelled) {
+        // Woken by the token, which is done with the waiter once detached
+        recordCall(operation, CallOutcome::Cancelled);
+        return QExpected<void>::err(operationName + " cancelled");
+    }
+
+    waiter.awaitCallback();
+    payload = std::move(waiter.payload);
+    recordCall(operation, payload.callerRet == RET_OK ? CallOutcome::Ok : CallOutcome::Failed, startedAt);
+    return QExpected<void>::ok();
+}
+
+template <typename BoundInvoke>
+QExpected<void> callApiRetVoid(
+    FfiOperation operation,
+    std::chrono::milliseconds timeout,
+    BoundInvoke&& invoke,
+    CancellationToken* cancellation = nullptr)
+{
+    CallbackPayload payload;
+    auto outcome = invokeAndWait(operation, timeout, std::forward<BoundInvoke>(invoke), payload, cancellation);
+    if (outcome.isErr()) {
+        return outcome;
     }
 
-    if (callbackCtx->payload.callerRet != RET_OK) {
-        const QString message = callbackCtx->payload.message.isEmpty()
-            ? operationName + " failed"
-            : callbackCtx->payload.message;
+    if (payload.callerRet != RET_OK) {
+        const QString message = payload.message.isEmpty()
+            ? ffiOperationName(operation) + " failed"
+            : payload.message;
         return QExpected<void>::err(message);
     }
 
@@ -94,67 +174,279 @@ QExpected<void> callApiRetVoid(const QString& operationName, std::chrono::second
 
 template <typename TResult, typename BoundInvoke>
 QExpected<TResult> callApiRetValue(
-    const QString& operationName,
-    std::chrono::seconds timeout,
-    BoundInvoke&& invoke)
+    FfiOperation operation,
+    std::chrono::milliseconds timeout,
+    BoundInvoke&& invoke,
+    CancellationToken* cancellation = nullptr)
 {
     static_assert(std::is_same_v<TResult, QString>, "callApiRetValue only supports QString payload; perform conversions at call site");
 
+    CallbackPayload payload;
+    auto outcome = invokeAndWait(operation, timeout, std::forward<BoundInvoke>(invoke), payload, cancellation);
+    if (outcome.isErr()) {
+        return QExpected<TResult>::err(outcome.error());
+    }
+
+    if (payload.callerRet != RET_OK) {
+        const QString message = payload.message.isEmpty()
+            ? ffiOperationName(operation) + " failed"
+            : payload.message;
+        return QExpected<TResult>::err(message);
+    }
+
+    return QExpected<TResult>::ok(payload.message);
+}
+
+/**
+ * Initiates every bound call back to back and waits for all of their callbacks
+ * together, so N calls cost one wait instead of N. `timeout` bounds the whole
+ * batch. Results are returned in the order of `invokes`; entries whose
+ * callback did not arrive in time carry a timeout error. Cancelling
+ * `cancellation` abandons every call still pending, which then carries a
+ * cancellation error.
+ */
+template <typename BoundInvoke>
+std::vector<QExpected<QString>> callApiRetValueMany(
+    FfiOperation operation,
+    std::chrono::milliseconds timeout,
+    std::vector<BoundInvoke>& invokes,
+    CancellationToken* cancellation = nullptr)
+{
+    enum class EntryState { Pending, NotInitiated, TimedOut, Cancelled };
+
+    struct BatchContext;
     struct CallbackContext {
-        std::binary_semaphore sem{0};
+        BatchContext* batch{nullptr};
+        void* key{nullptr};
+        EntryState state{EntryState::Pending};
+        std::chrono::steady_clock::time_point startedAt;
+        std::chrono::steady_clock::time_point completedAt;
         CallbackPayload payload;
     };
+    struct BatchContext {
+        std::vector<CallbackContext> entries;
+        std::atomic<size_t> remaining{0};
+        std::binary_semaphore sem{0};
+        std::atomic<bool> released{false};
 
-    static std::mutex pendingMutex;
-    static std::unordered_map<void*, std::shared_ptr<CallbackContext>> pendingContexts;
-
-    auto callbackCtx = std::make_shared<CallbackContext>();
-    void* callbackKey = static_cast<void*>(callbackCtx.get());
-
-    {
-        std::lock_guard<std::mutex> lock(pendingMutex);
-        pendingContexts[callbackKey] = callbackCtx;
-    }
+        void settle(size_t count)
+        {
+            if (count > 0 && remaining.fetch_sub(count) == count) {
+                sem.release();
+                // Last access: the waiter returns once it sees this
+                released.store(true, std::memory_order_release);
+            }
+        }
 
-    auto callback = +[](int callerRet, const char* msg, size_t len, void* userData) {
-        std::shared_ptr<CallbackContext> callbackCtx;
+        // Called once the semaphore has been acquired
+        void awaitRelease() const
         {
-            std::lock_guard<std::mutex> lock(pendingMutex);
-            auto it = pendingContexts.find(userData);
-            if (it == pendingContexts.end()) {
-                return;
+            while (!released.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
             }
-            callbackCtx = it->second;
-            pendingContexts.erase(it);
         }
+    };
 
-        callbackCtx->payload.callerRet = callerRet;
+    auto complete = +[](void* target, int callerRet, const char* msg, size_t len) {
+        auto* entry = static_cast<CallbackContext*>(target);
+        entry->completedAt = std::chrono::steady_clock::now();
+        entry->payload.callerRet = callerRet;
         if (msg && len > 0) {
-            callbackCtx->payload.message = QString::fromUtf8(msg, len);
+            entry->payload.message = QString::fromUtf8(msg, len);
         }
-        callbackCtx->sem.release();
+        entry->batch->settle(1);
     };
 
-    int startResult = invoke(callback, callbackKey);
-    if (startResult != RET_OK) {
-        std::lock_guard<std::mutex> lock(pendingMutex);
-        pendingContexts.erase(callbackKey);
-        return QExpected<TResult>::err("failed to initiate " + operationName);
+    std::vector<QExpected<QString>> results;
+    results.reserve(invokes.size());
+    if (invokes.empty()) {
+        return results;
+    }
+
+    const QString& operationName = ffiOperationName(operation);
+    PendingCallTable& table = PendingCallTable::instance();
+    BatchContext batch;
+    batch.entries.resize(invokes.size());
+    batch.remaining.store(invokes.size());
+
+    for (size_t i = 0; i < invokes.size(); ++i) {
+        CallbackContext& entry = batch.entries[i];
+        entry.batch = &batch;
+        entry.key = table.claim(complete, &entry);
+        if (!entry.key) {
+            entry.state = EntryState::NotInitiated;
+            batch.settle(1);
+            continue;
+        }
+        entry.startedAt = std::chrono::steady_clock::now();
+        if (invokes[i](&PendingCallTable::dispatch, entry.key) != RET_OK && table.cancel(entry.key)) {
+            entry.state = EntryState::NotInitiated;
+            batch.settle(1);
+        }
     }
 
-    if (!callbackCtx->sem.try_acquire_for(timeout)) {
-        std::lock_guard<std::mutex> lock(pendingMutex);
-        pendingContexts.erase(callbackKey);
-        return QExpected<TResult>::err(operationName + " callback timeout");
+    // Runs on the cancelling thread under the token's lock; cancelled entries settle like callbacks
+    auto cancelPending = [&batch, &table]() {
+        size_t cancelled = 0;
+        for (auto& entry : batch.entries) {
+            if (entry.state == EntryState::Pending && table.cancel(entry.key)) {
+                entry.state = EntryState::Cancelled;
+                ++cancelled;
+            }
+        }
+        batch.settle(cancelled);
+    };
+    if (cancellation && !cancellation->attach(cancelPending)) {
+        cancelPending();
+        cancellation = nullptr;
     }
 
-    if (callbackCtx->payload.callerRet != RET_OK) {
-        const QString message = callbackCtx->payload.message.isEmpty()
-            ? operationName + " failed"
-            : callbackCtx->payload.message;
-        return QExpected<TResult>::err(message);
+    const bool woken = batch.sem.try_acquire_for(timeout);
+    if (cancellation) {
+        cancellation->detach();
+    }
+    if (woken) {
+        batch.awaitRelease();
+    } else {
+        size_t abandoned = 0;
+        for (auto& entry : batch.entries) {
+            if (entry.state == EntryState::Pending && table.cancel(entry.key)) {
+                entry.state = EntryState::TimedOut;
+                ++abandoned;
+            }
+        }
+        // Callbacks that already claimed their entry are finishing right now
+        // (or the last one just did); wait for them before the batch goes out of scope.
+        if (abandoned == 0 || batch.remaining.fetch_sub(abandoned) != abandoned) {
+            batch.sem.acquire();
+            batch.awaitRelease();
+        }
+    }
+
+    DeliveryMetrics& metrics = DeliveryMetrics::instance();
+    for (const CallbackContext& entry : batch.entries) {
+        if (entry.state == EntryState::NotInitiated) {
+            metrics.recordCall(operation, CallOutcome::NotInitiated, {});
+            results.push_back(QExpected<QString>::err(entry.key
+                ? "failed to initiate " + operationName
+                : pendingTableFullError(operationName)));
+        } else if (entry.state == EntryState::TimedOut) {
+            metrics.recordCall(operation, CallOutcome::Timeout, {});
+            results.push_back(QExpected<QString>::err(operationName + " callback timeout"));
+        } else if (entry.state == EntryState::Cancelled) {
+            metrics.recordCall(operation, CallOutcome::Cancelled, {});
+            results.push_back(QExpected<QString>::err(operationName + " cancelled"));
+        } else if (entry.payload.callerRet != RET_OK) {
+            metrics.recordCall(operation, CallOutcome::Failed, entry.completedAt - entry.startedAt);
+            results.push_back(QExpected<QString>::err(entry.payload.message.isEmpty()
+                ? operationName + " failed"
+                : entry.payload.message));
+        } else {
+            metrics.recordCall(operation, CallOutcome::Ok, entry.completedAt - entry.startedAt);
+            results.push_back(QExpected<QString>::ok(entry.payload.message));
+        }
     }
 
-    return QExpected<TResult>::ok(callbackCtx->payload.message);
+    return results;
+}
+
+/**
+ * callApiRetValueMany for calls whose callback carries no value of interest.
+ */
+template <typename BoundInvoke>
+std::vector<QExpected<void>> callApiRetVoidMany(
+    FfiOperation operation,
+    std::chrono::milliseconds timeout,
+    std::vector<BoundInvoke>& invokes)
+{
+    const auto outcomes = callApiRetValueMany(operation, timeout, invokes);
+    std::vector<QExpected<void>> results;
+    results.reserve(outcomes.size());
+    for (const auto& outcome : outcomes) {
+        results.push_back(outcome.isOk() ? QExpected<void>::ok() : QExpected<void>::err(outcome.error()));
+    }
+    return results;
+}
+
+using AsyncCompletion = std::function<void(const QExpected<QString>&)>;
+
+/**
+ * Fire-and-forget variant of callApiRetValue: returns as soon as the FFI call
+ * is initiated and reports the callback outcome through `onComplete`, which
+ * runs on the liblogosdelivery thread. `onComplete` is invoked exactly once
+ * unless an error is returned, in which case it never runs; it also owns
+ * anything the bound call needs to keep alive until then.
+ *
+ * The call is registered in `registry` with a deadline of `timeout`. If it is
+ * abandoned there before its callback arrives, `onComplete` gets a timeout (or
+ * cancellation) error instead, on the thread that abandoned it.
+ */
+template <typename BoundInvoke>
+QExpected<void> callApiAsync(
+    FfiOperation operation,
+    std::chrono::milliseconds timeout,
+    BoundInvoke&& invoke,
+    AsyncCompletion onComplete,
+    AsyncCallRegistry& registry)
+{
+    struct AsyncCall {
+        FfiOperation operation;
+        AsyncCompletion onComplete;
+        std::chrono::steady_clock::time_point startedAt;
+        AsyncCallRegistry* registry;
+        void* key{nullptr};
+    };
+
+    auto complete = +[](void* target, int callerRet, const char* msg, size_t len) {
+        auto* call = static_cast<AsyncCall*>(target);
+        recordCall(call->operation, callerRet == RET_OK ? CallOutcome::Ok : CallOutcome::Failed, call->startedAt);
+        const QString message = (msg && len > 0) ? QString::fromUtf8(msg, len) : QString();
+        if (callerRet != RET_OK) {
+            call->onComplete(QExpected<QString>::err(
+                message.isEmpty() ? ffiOperationName(call->operation) + " failed" : message));
+        } else {
+            call->onComplete(QExpected<QString>::ok(message));
+        }
+        AsyncCallRegistry* registry = call->registry;
+        void* key = call->key;
+        delete call;
+        registry->remove(key);
+    };
+
+    auto abandon = +[](void* target, AsyncCallRegistry::Reason reason) {
+        auto* call = static_cast<AsyncCall*>(target);
+        const bool expired = reason == AsyncCallRegistry::Reason::Expired;
+        recordCall(call->operation, expired ? CallOutcome::Timeout : CallOutcome::Cancelled);
+        call->onComplete(QExpected<QString>::err(
+            ffiOperationName(call->operation) + (expired ? " callback timeout" : " cancelled")));
+        delete call;
+    };
+
+    const QString& operationName = ffiOperationName(operation);
+    PendingCallTable& table = PendingCallTable::instance();
+    const auto startedAt = std::chrono::steady_clock::now();
+    auto* call = new AsyncCall{operation, std::move(onComplete), startedAt, &registry};
+    void* callbackKey = table.claim(complete, call);
+    if (!callbackKey) {
+        delete call;
+        recordCall(operation, CallOutcome::NotInitiated);
+        return QExpected<void>::err(pendingTableFullError(operationName));
+    }
+    call->key = callbackKey;
+    registry.add(callbackKey, startedAt + timeout, abandon, call);
+
+    int startResult = invoke(&PendingCallTable::dispatch, callbackKey);
+    if (startResult != RET_OK) {
+        // If the callback already ran (or the call expired) it also released the call and reported the outcome
+        if (!table.cancel(callbackKey)) {
+            return QExpected<void>::ok();
+        }
+        registry.remove(callbackKey);
+        delete call;
+        recordCall(operation, CallOutcome::NotInitiated);
+        return QExpected<void>::err("failed to initiate " + operationName);
+    }
+
+    return QExpected<void>::ok();
 }
 } // namespace
@@ -0,0 +1,58 @@
+#include "async_call_registry.h"
+
+#include <vector>
+
+void AsyncCallRegistry::add(void* key, Clock::time_point deadline, AbandonFn abandon, void* target)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_calls[key] = Call{deadline, abandon, target};
+}
+
+void AsyncCallRegistry::remove(void* key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_calls.erase(key);
+    if (m_calls.empty()) {
+        m_drained.notify_all();
+    }
+}
+
+size_t AsyncCallRegistry::abandon(Clock::time_point deadline, Reason reason)
+{
+    std::vector<Call> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_calls.begin(); it != m_calls.end();) {
+            // A failed cancel means the callback is completing the call right now
+            if (it->second.deadline <= deadline && m_table.cancel(it->first)) {
+                abandoned.push_back(it->second);
+                it = m_calls.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    // Completions may take other locks, so they run after ours is released
+    for (const Call& call : abandoned) {
+        call.abandon(call.target, reason);
+    }
+    return abandoned.size();
+}
+
+size_t AsyncCallRegistry::expire(Clock::time_point now)
+{
+    return abandon(now, Reason::Expired);
+}
+
+void AsyncCallRegistry::cancelAll()
+{
+    abandon(Clock::time_point::max(), Reason::Shutdown);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_drained.wait(lock, [this]() { return m_calls.empty(); });
+}
+
+size_t AsyncCallRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_calls.size();
+}
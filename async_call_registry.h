@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include "pending_call_table.h"
+
+/**
+ * @brief Deadlines of the fire-and-forget calls started by `callApiAsync`.
+ *
+ * liblogosdelivery may never call back, e.g. when the node is stopped or
+ * destroyed mid-call. @ref expire cancels calls past their deadline in the
+ * PendingCallTable and abandons them, which completes them with an error so
+ * that whatever they hold is released. A call whose callback is already
+ * running cannot be cancelled any more; it leaves the registry through
+ * @ref remove once its completion has finished.
+ */
+class AsyncCallRegistry {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Reason : uint8_t {
+        Expired,  ///< No callback before the deadline.
+        Shutdown, ///< Abandoned by @ref cancelAll.
+    };
+
+    /**
+     * @brief Completes an abandoned call; runs on the thread that abandoned it.
+     */
+    using AbandonFn = void (*)(void* target, Reason reason);
+
+    explicit AsyncCallRegistry(PendingCallTable& table = PendingCallTable::instance()) : m_table(table) {}
+
+    AsyncCallRegistry(const AsyncCallRegistry&) = delete;
+    AsyncCallRegistry& operator=(const AsyncCallRegistry&) = delete;
+
+    /**
+     * @brief Registers a claimed call; must happen before the call is initiated.
+     */
+    void add(void* key, Clock::time_point deadline, AbandonFn abandon, void* target);
+
+    /**
+     * @brief Unregisters a call whose completion has finished or that was never initiated.
+     */
+    void remove(void* key);
+
+    /**
+     * @brief Abandons the calls whose deadline is at or before @p now.
+     * @return Number of abandoned calls.
+     */
+    size_t expire(Clock::time_point now);
+
+    /**
+     * @brief Abandons every call and waits for completions that are already running.
+     *
+     * Once this returns no completion of a registered call runs any more.
+     */
+    void cancelAll();
+
+    size_t size() const;
+
+private:
+    struct Call {
+        Clock::time_point deadline;
+        AbandonFn abandon{nullptr};
+        void* target{nullptr};
+    };
+
+    size_t abandon(Clock::time_point deadline, Reason reason);
+
+    PendingCallTable& m_table;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_drained;
+    std::unordered_map<void*, Call> m_calls;
+};
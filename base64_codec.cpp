@@ -0,0 +1,281 @@
+#include "base64_codec.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DELIVERY_BASE64_X86 1
+#include <immintrin.h>
+#else
+#define DELIVERY_BASE64_X86 0
+#endif
+
+namespace {
+constexpr char ENCODE_TABLE[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+// The vector decoders store a whole register per step, past the bytes they produce
+constexpr qsizetype DECODE_SLACK = 32;
+
+struct DecodeTable {
+    int8_t values[256];
+
+    constexpr DecodeTable() : values()
+    {
+        for (int i = 0; i < 256; ++i) {
+            values[i] = -1;
+        }
+        for (int i = 0; i < 64; ++i) {
+            values[static_cast<uint8_t>(ENCODE_TABLE[i])] = static_cast<int8_t>(i);
+        }
+    }
+};
+constexpr DecodeTable DECODE_TABLE;
+
+void encodeScalar(const uint8_t* src, size_t length, char* dst)
+{
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3) {
+        const uint32_t triple = (uint32_t(src[i]) << 16) | (uint32_t(src[i + 1]) << 8) | src[i + 2];
+        *dst++ = ENCODE_TABLE[triple >> 18];
+        *dst++ = ENCODE_TABLE[(triple >> 12) & 0x3f];
+        *dst++ = ENCODE_TABLE[(triple >> 6) & 0x3f];
+        *dst++ = ENCODE_TABLE[triple & 0x3f];
+    }
+    if (i < length) {
+        const bool two = i + 1 < length;
+        const uint32_t triple = (uint32_t(src[i]) << 16) | (two ? uint32_t(src[i + 1]) << 8 : 0);
+        *dst++ = ENCODE_TABLE[triple >> 18];
+        *dst++ = ENCODE_TABLE[(triple >> 12) & 0x3f];
+        *dst++ = two ? ENCODE_TABLE[(triple >> 6) & 0x3f] : '=';
+        *dst++ = '=';
+    }
+}
+
+// Same results as QByteArray::fromBase64 without options: characters outside
+// the alphabet, padding included, are skipped.
+size_t decodeScalar(const char* src, size_t length, char* dst)
+{
+    uint32_t buffer = 0;
+    int bits = 0;
+    size_t written = 0;
+    for (size_t i = 0; i < length; ++i) {
+        const int8_t value = DECODE_TABLE.values[static_cast<uint8_t>(src[i])];
+        if (value < 0) {
+            continue;
+        }
+        buffer = (buffer << 6) | uint32_t(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            dst[written++] = static_cast<char>(buffer >> bits);
+            buffer &= (1u << bits) - 1;
+        }
+    }
+    return written;
+}
+
+#if DELIVERY_BASE64_X86
+// Kernels after W. Muła and D. Lemire, "Faster Base64 Encoding and Decoding
+// using AVX2 Instructions" (2018). Each consumes whole blocks and returns how
+// many input bytes it used; the caller finishes the rest.
+
+__attribute__((target("ssse3"))) size_t encodeSsse3(const uint8_t* src, size_t length, char* dst)
+{
+    const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m128i shiftLut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    size_t i = 0;
+    // 12 bytes become 16 characters; the load reads 16
+    for (; i + 16 <= length; i += 12, dst += 16) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        in = _mm_shuffle_epi8(in, shuffle);
+        const __m128i high = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        const __m128i low = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(high, low);
+        __m128i lutIndex = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        lutIndex = _mm_or_si128(lutIndex, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+        const __m128i out = _mm_add_epi8(_mm_shuffle_epi8(shiftLut, lutIndex), indices);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), out);
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) size_t encodeAvx2(const uint8_t* src, size_t length, char* dst)
+{
+    const __m256i shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m256i shiftLut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    size_t i = 0;
+    // 24 bytes become 32 characters; each lane loads 16 bytes, the upper one from offset 12
+    for (; i + 28 <= length; i += 24, dst += 32) {
+        const __m128i lowLane = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i highLane = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lowLane), highLane, 1);
+        in = _mm256_shuffle_epi8(in, shuffle);
+        const __m256i high = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)),
+            _mm256_set1_epi32(0x04000040));
+        const __m256i low = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)),
+            _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(high, low);
+        __m256i lutIndex = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        lutIndex = _mm256_or_si256(lutIndex,
+            _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+        const __m256i out = _mm256_add_epi8(_mm256_shuffle_epi8(shiftLut, lutIndex), indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), out);
+    }
+    return i;
+}
+
+// Stops at the first block holding anything but alphabet characters
+__attribute__((target("ssse3"))) size_t decodeSsse3(const char* src, size_t length, char* dst, size_t& written)
+{
+    const __m128i lutLow = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m128i lutHigh = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16, written += 12) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i highNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+        const __m128i lowNibbles = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+        const __m128i invalid = _mm_and_si128(_mm_shuffle_epi8(lutLow, lowNibbles), _mm_shuffle_epi8(lutHigh, highNibbles));
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(invalid, _mm_setzero_si128())) != 0) {
+            break;
+        }
+        const __m128i isSlash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+        in = _mm_add_epi8(in, _mm_shuffle_epi8(lutRoll, _mm_add_epi8(isSlash, highNibbles)));
+        const __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + written), _mm_shuffle_epi8(merged, pack));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) size_t decodeAvx2(const char* src, size_t length, char* dst, size_t& written)
+{
+    const __m256i lutLow = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m256i lutHigh = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lutRoll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i joinLanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32, written += 24) {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i highNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0f));
+        const __m256i lowNibbles = _mm256_and_si256(in, _mm256_set1_epi8(0x0f));
+        const __m256i invalid = _mm256_and_si256(_mm256_shuffle_epi8(lutLow, lowNibbles),
+            _mm256_shuffle_epi8(lutHigh, highNibbles));
+        if (_mm256_movemask_epi8(_mm256_cmpgt_epi8(invalid, _mm256_setzero_si256())) != 0) {
+            break;
+        }
+        const __m256i isSlash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+        in = _mm256_add_epi8(in, _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(isSlash, highNibbles)));
+        const __m256i merged = _mm256_madd_epi16(_mm256_maddubs_epi16(in, _mm256_set1_epi32(0x01400140)),
+            _mm256_set1_epi32(0x00011000));
+        const __m256i out = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(merged, pack), joinLanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + written), out);
+    }
+    return i;
+}
+#endif
+
+Base64Kernel detectKernel()
+{
+#if DELIVERY_BASE64_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Base64Kernel::Avx2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return Base64Kernel::Ssse3;
+    }
+#endif
+    return Base64Kernel::Scalar;
+}
+} // namespace
+
+Base64Kernel base64Kernel()
+{
+    static const Base64Kernel kernel = detectKernel();
+    return kernel;
+}
+
+bool base64KernelSupported(Base64Kernel kernel)
+{
+    return static_cast<uint8_t>(kernel) <= static_cast<uint8_t>(base64Kernel());
+}
+
+const char* base64KernelName(Base64Kernel kernel)
+{
+    switch (kernel) {
+    case Base64Kernel::Scalar: return "scalar";
+    case Base64Kernel::Ssse3: return "ssse3";
+    case Base64Kernel::Avx2: return "avx2";
+    }
+    return "unknown";
+}
+
+void appendBase64(QByteArray& out, std::string_view bytes, Base64Kernel kernel)
+{
+    const qsizetype start = out.size();
+    out.resize(start + static_cast<qsizetype>((bytes.size() + 2) / 3 * 4));
+    const auto* src = reinterpret_cast<const uint8_t*>(bytes.data());
+    size_t length = bytes.size();
+    char* dst = out.data() + start;
+
+    if (!base64KernelSupported(kernel)) {
+        kernel = base64Kernel();
+    }
+#if DELIVERY_BASE64_X86
+    // Each kernel hands its tail to the next slower one
+    if (kernel == Base64Kernel::Avx2) {
+        const size_t used = encodeAvx2(src, length, dst);
+        src += used;
+        length -= used;
+        dst += used / 3 * 4;
+    }
+    if (kernel != Base64Kernel::Scalar) {
+        const size_t used = encodeSsse3(src, length, dst);
+        src += used;
+        length -= used;
+        dst += used / 3 * 4;
+    }
+#endif
+    encodeScalar(src, length, dst);
+}
+
+QByteArray decodeBase64(std::string_view base64, Base64Kernel kernel)
+{
+    QByteArray out(static_cast<qsizetype>(base64.size() / 4 * 3 + 3) + DECODE_SLACK, Qt::Uninitialized);
+    const char* src = base64.data();
+    size_t length = base64.size();
+    char* dst = out.data();
+    size_t written = 0;
+
+    if (!base64KernelSupported(kernel)) {
+        kernel = base64Kernel();
+    }
+#if DELIVERY_BASE64_X86
+    if (kernel == Base64Kernel::Avx2) {
+        const size_t used = decodeAvx2(src, length, dst, written);
+        src += used;
+        length -= used;
+    }
+    if (kernel != Base64Kernel::Scalar) {
+        const size_t used = decodeSsse3(src, length, dst, written);
+        src += used;
+        length -= used;
+    }
+#endif
+    written += decodeScalar(src, length, dst + written);
+    out.truncate(static_cast<qsizetype>(written));
+    return out;
+}
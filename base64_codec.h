@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Implementations of the base64 kernels, from slowest to fastest.
+ */
+enum class Base64Kernel : uint8_t {
+    Scalar, ///< Portable table-driven code.
+    Ssse3,  ///< 16 characters per step with `pshufb` lookups (x86-64).
+    Avx2,   ///< 32 characters per step (x86-64).
+};
+
+/**
+ * @brief Fastest kernel the running CPU supports, detected once.
+ */
+Base64Kernel base64Kernel();
+
+bool base64KernelSupported(Base64Kernel kernel);
+
+const char* base64KernelName(Base64Kernel kernel);
+
+/**
+ * @brief Appends the padded base64 encoding of @p bytes to @p out.
+ *
+ * Produces exactly what `QByteArray::toBase64()` does. An unsupported
+ * @p kernel falls back to the next slower one.
+ */
+void appendBase64(QByteArray& out, std::string_view bytes, Base64Kernel kernel = base64Kernel());
+
+/**
+ * @brief `QByteArray::toBase64()` on the vectorized kernels.
+ */
+inline QByteArray encodeBase64(const QByteArray& bytes)
+{
+    QByteArray out;
+    appendBase64(out, std::string_view(bytes.constData(), static_cast<size_t>(bytes.size())));
+    return out;
+}
+
+/**
+ * @brief Decodes base64 like `QByteArray::fromBase64()` with default options.
+ *
+ * Blocks of plain alphabet characters go through the vector kernels; the
+ * rest, including padding, is decoded by the scalar code, which skips any
+ * character outside the alphabet, so the result always matches Qt's.
+ */
+QByteArray decodeBase64(std::string_view base64, Base64Kernel kernel = base64Kernel());
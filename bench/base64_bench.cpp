@@ -0,0 +1,94 @@
+// Microbenchmark: base64 kernels used on the send and receive payload paths
+// against QByteArray::toBase64 / QByteArray::fromBase64.
+#include <QByteArray>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include "../base64_codec.h"
+
+namespace {
+
+QByteArray makePayload(int payloadBytes)
+{
+    QByteArray payload(payloadBytes, Qt::Uninitialized);
+    uint32_t state = 0x9e3779b9u;
+    for (int i = 0; i < payloadBytes; ++i) {
+        state = state * 1664525u + 1013904223u;
+        payload[i] = static_cast<char>(state >> 24);
+    }
+    return payload;
+}
+
+std::string_view view(const QByteArray& bytes)
+{
+    return std::string_view(bytes.constData(), static_cast<size_t>(bytes.size()));
+}
+
+// Throughput in MiB/s of payload bytes
+template <typename Run>
+double mibPerSecond(int payloadBytes, int iterations, Run run)
+{
+    qsizetype sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sink += run();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (sink == 0) {
+        std::fprintf(stderr, "unexpected empty result\n");
+    }
+    return static_cast<double>(payloadBytes) * iterations / seconds / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+int main()
+{
+    const std::vector<int> payloadSizes{1024, 16 * 1024, 64 * 1024, 150 * 1024};
+    std::vector<Base64Kernel> kernels;
+    for (Base64Kernel kernel : {Base64Kernel::Scalar, Base64Kernel::Ssse3, Base64Kernel::Avx2}) {
+        if (base64KernelSupported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+    std::printf("runtime kernel: %s\n\n", base64KernelName(base64Kernel()));
+
+    std::printf("%-10s %-8s %-14s %-14s %-10s %-10s\n", "payload", "kernel", "encode MiB/s", "decode MiB/s",
+        "enc vs Qt", "dec vs Qt");
+    for (int payloadBytes : payloadSizes) {
+        const QByteArray payload = makePayload(payloadBytes);
+        const QByteArray encoded = payload.toBase64();
+        const int iterations = std::max(200, (64 << 20) / payloadBytes);
+
+        // Warm up caches and the allocator before measuring
+        mibPerSecond(payloadBytes, iterations / 10, [&] { return payload.toBase64().size(); });
+
+        const double qtEncode = mibPerSecond(payloadBytes, iterations, [&] { return payload.toBase64().size(); });
+        const double qtDecode = mibPerSecond(payloadBytes, iterations, [&] { return QByteArray::fromBase64(encoded).size(); });
+        std::printf("%-10d %-8s %-14.0f %-14.0f %-10s %-10s\n", payloadBytes, "qt", qtEncode, qtDecode, "1.00", "1.00");
+
+        for (Base64Kernel kernel : kernels) {
+            QByteArray check;
+            appendBase64(check, view(payload), kernel);
+            if (check != encoded || decodeBase64(view(encoded), kernel) != payload) {
+                std::fprintf(stderr, "%s kernel disagrees with Qt\n", base64KernelName(kernel));
+                return 1;
+            }
+
+            const double encode = mibPerSecond(payloadBytes, iterations, [&] {
+                QByteArray out;
+                appendBase64(out, view(payload), kernel);
+                return out.size();
+            });
+            const double decode = mibPerSecond(payloadBytes, iterations, [&] {
+                return decodeBase64(view(encoded), kernel).size();
+            });
+            std::printf("%-10d %-8s %-14.0f %-14.0f %-10.2f %-10.2f\n", payloadBytes, base64KernelName(kernel),
+                encode, decode, encode / qtEncode, decode / qtDecode);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,436 @@
+// Hot path benchmarks for DeliveryModulePlugin, run against the loopback mock
+// liblogosdelivery (LOGOS_DELIVERY_MODULE_USE_MOCK=ON):
+//
+//   send        DeliveryModulePlugin::send from N threads
+//   ingest      event_callback for message_received events of several sizes,
+//               timed per call; throughput covers dispatch of every event
+//   roundtrip   callApiRetValue against logosdelivery_get_node_info
+//   emit        emitEvent up to the Logos API hand-off
+//
+// Usage: delivery_module_bench [--iterations N] [--threads 1,2,4,8] [--json]
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "../api_call_handler.h"
+#include "../delivery_module_plugin.h"
+
+namespace {
+
+// Every heap allocation in the process, on any thread. Only glibc lets the
+// bench see malloc itself; elsewhere just operator new is counted, which
+// misses Qt's container allocations, so allocsPerOp is reported as unavailable.
+std::atomic<uint64_t> allocationCount{0};
+
+#if defined(__GLIBC__)
+constexpr bool kCountsMalloc = true;
+#else
+constexpr bool kCountsMalloc = false;
+#endif
+
+inline void countAllocation()
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+#if defined(__GLIBC__)
+// Qt containers allocate with malloc directly, so count at that level
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size) noexcept
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) noexcept
+{
+    countAllocation();
+    return __libc_realloc(ptr, size);
+}
+}
+#else
+void* operator new(size_t size)
+{
+    countAllocation();
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+struct DeliveryModuleBenchAccess {
+    static void* context(DeliveryModulePlugin& plugin) { return plugin.deliveryCtx; }
+
+    static void ingest(DeliveryModulePlugin& plugin, const QByteArray& event)
+    {
+        DeliveryModulePlugin::event_callback(RET_OK, event.constData(), static_cast<size_t>(event.size()), &plugin);
+    }
+
+    static void emitEvent(DeliveryModulePlugin& plugin, DeliveryEventType type, const QVariantList& data)
+    {
+        plugin.emitEvent(type, data, std::chrono::steady_clock::now());
+    }
+
+    static EventRing<DeliveryModulePlugin::QueuedEvent>::Stats queueStats(DeliveryModulePlugin& plugin)
+    {
+        return plugin.eventQueue.stats();
+    }
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Access = DeliveryModuleBenchAccess;
+
+struct Result {
+    QString name;
+    QJsonObject params;
+    uint64_t ops{0};
+    uint64_t errors{0};
+    double seconds{0};
+    uint64_t allocations{0};
+    std::vector<int64_t> samplesNs;
+};
+
+int64_t percentile(const std::vector<int64_t>& sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(fraction * static_cast<double>(sorted.size())));
+    return sorted[index];
+}
+
+QJsonObject toJson(Result& result)
+{
+    std::sort(result.samplesNs.begin(), result.samplesNs.end());
+    QJsonObject json;
+    json["name"] = result.name;
+    json["params"] = result.params;
+    json["ops"] = static_cast<qint64>(result.ops);
+    json["errors"] = static_cast<qint64>(result.errors);
+    json["opsPerSec"] = result.seconds > 0 ? static_cast<double>(result.ops) / result.seconds : 0.0;
+    json["p50Ns"] = static_cast<qint64>(percentile(result.samplesNs, 0.50));
+    json["p99Ns"] = static_cast<qint64>(percentile(result.samplesNs, 0.99));
+    json["p999Ns"] = static_cast<qint64>(percentile(result.samplesNs, 0.999));
+    const double perOp = result.ops ? static_cast<double>(result.allocations) / static_cast<double>(result.ops) : 0.0;
+    if (kCountsMalloc) {
+        json["allocsPerOp"] = perOp;
+    } else {
+        json["allocsPerOp"] = QJsonValue::Null;
+        json["operatorNewPerOp"] = perOp;
+    }
+    return json;
+}
+
+int64_t elapsedNs(Clock::time_point from, Clock::time_point to)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+QByteArray makeReceivedEvent(int payloadBytes)
+{
+    QByteArray payload(payloadBytes, 'x');
+    for (int i = 0; i < payloadBytes; ++i) {
+        payload[i] = static_cast<char>(i * 31);
+    }
+    return QByteArray("{\"eventType\":\"message_received\",\"requestId\":\"\","
+                      "\"messageHash\":\"0x5f0a7c1d2e3b4a596877869504a3b2c1d0e0f1a2b3c4d5e6f708192a3b4c5d6e\","
+                      "\"message\":{\"payload\":\"")
+        + payload.toBase64()
+        + QByteArray("\",\"contentTopic\":\"/bench/1/events/proto\",\"meta\":\"\",\"version\":0,"
+                     "\"timestamp\":1712345678901234567,\"ephemeral\":false}}");
+}
+
+Result benchSend(DeliveryModulePlugin& plugin, int threads, int iterations)
+{
+    Result result;
+    result.name = "send";
+    result.params["threads"] = threads;
+    result.params["payloadBytes"] = 256;
+
+    const QString topic = QStringLiteral("/bench/1/send/proto");
+    const QString payload(256, QLatin1Char('p'));
+    std::vector<std::vector<int64_t>> samples(static_cast<size_t>(threads));
+    for (auto& perThread : samples) {
+        perThread.reserve(static_cast<size_t>(iterations));
+    }
+    std::atomic<uint64_t> errors{0};
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            auto& mine = samples[static_cast<size_t>(t)];
+            ready.fetch_add(1);
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < iterations; ++i) {
+                const auto startedAt = Clock::now();
+                if (plugin.send(topic, payload).isErr()) {
+                    errors.fetch_add(1, std::memory_order_relaxed);
+                }
+                mine.push_back(elapsedNs(startedAt, Clock::now()));
+            }
+        });
+    }
+    while (ready.load() < threads) {
+        std::this_thread::yield();
+    }
+
+    const uint64_t allocationsBefore = allocationCount.load();
+    const auto startedAt = Clock::now();
+    go.store(true);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    result.seconds = elapsedNs(startedAt, Clock::now()) / 1e9;
+    result.allocations = allocationCount.load() - allocationsBefore;
+
+    for (const auto& perThread : samples) {
+        result.samplesNs.insert(result.samplesNs.end(), perThread.begin(), perThread.end());
+    }
+    result.ops = result.samplesNs.size();
+    result.errors = errors.load();
+    return result;
+}
+
+Result benchIngest(DeliveryModulePlugin& plugin, int payloadBytes, int iterations)
+{
+    Result result;
+    result.name = "ingest";
+    result.params["payloadBytes"] = payloadBytes;
+
+    const QByteArray event = makeReceivedEvent(payloadBytes);
+    const auto before = Access::queueStats(plugin);
+    // Stay well below capacity so the numbers describe ingestion, not drops
+    const size_t backlogLimit = before.capacity / 2;
+    result.samplesNs.reserve(static_cast<size_t>(iterations));
+
+    const uint64_t allocationsBefore = allocationCount.load();
+    const auto startedAt = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        while (Access::queueStats(plugin).depth >= backlogLimit) {
+            std::this_thread::yield();
+        }
+        const auto callStartedAt = Clock::now();
+        Access::ingest(plugin, event);
+        result.samplesNs.push_back(elapsedNs(callStartedAt, Clock::now()));
+    }
+    while (Access::queueStats(plugin).popped < before.popped + static_cast<uint64_t>(iterations)
+           && Access::queueStats(plugin).dropped == before.dropped) {
+        std::this_thread::yield();
+    }
+    result.seconds = elapsedNs(startedAt, Clock::now()) / 1e9;
+    result.allocations = allocationCount.load() - allocationsBefore;
+
+    result.ops = static_cast<uint64_t>(iterations);
+    result.errors = Access::queueStats(plugin).dropped - before.dropped;
+    return result;
+}
+
+Result benchRoundTrip(DeliveryModulePlugin& plugin, int iterations)
+{
+    Result result;
+    result.name = "roundtrip";
+    result.params["call"] = "get_node_info";
+
+    static const char* const kVersionId = "Version";
+    void* ctx = Access::context(plugin);
+    result.samplesNs.reserve(static_cast<size_t>(iterations));
+
+    const uint64_t allocationsBefore = allocationCount.load();
+    const auto startedAt = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        const auto callStartedAt = Clock::now();
+        auto outcome = callApiRetValue<QString>(
+            FfiOperation::GetNodeInfo,
+            std::chrono::seconds(5),
+            bindApiCall(logosdelivery_get_node_info, ctx, kVersionId));
+        result.samplesNs.push_back(elapsedNs(callStartedAt, Clock::now()));
+        if (outcome.isErr()) {
+            ++result.errors;
+        }
+    }
+    result.seconds = elapsedNs(startedAt, Clock::now()) / 1e9;
+    result.allocations = allocationCount.load() - allocationsBefore;
+    result.ops = static_cast<uint64_t>(iterations);
+    return result;
+}
+
+Result benchEmit(DeliveryModulePlugin& plugin, int iterations)
+{
+    Result result;
+    result.name = "emit";
+    result.params["logosApi"] = false;
+
+    QVariantList data;
+    data << QStringLiteral("0000000000000001")
+         << QStringLiteral("0x5f0a7c1d2e3b4a596877869504a3b2c1d0e0f1a2b3c4d5e6f708192a3b4c5d6e")
+         << QStringLiteral("2024-04-05T12:34:56");
+    result.samplesNs.reserve(static_cast<size_t>(iterations));
+
+    const uint64_t allocationsBefore = allocationCount.load();
+    const auto startedAt = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        const auto callStartedAt = Clock::now();
+        Access::emitEvent(plugin, DeliveryEventType::MessageSent, data);
+        result.samplesNs.push_back(elapsedNs(callStartedAt, Clock::now()));
+    }
+    result.seconds = elapsedNs(startedAt, Clock::now()) / 1e9;
+    result.allocations = allocationCount.load() - allocationsBefore;
+    result.ops = static_cast<uint64_t>(iterations);
+    return result;
+}
+
+void printText(const QJsonObject& json)
+{
+    QString label = json["name"].toString();
+    const QJsonObject params = json["params"].toObject();
+    for (auto it = params.begin(); it != params.end(); ++it) {
+        label += QStringLiteral(" %1=%2").arg(it.key(), it.value().toVariant().toString());
+    }
+    char allocs[32] = "n/a";
+    if (!json["allocsPerOp"].isNull()) {
+        std::snprintf(allocs, sizeof(allocs), "%.1f", json["allocsPerOp"].toDouble());
+    }
+    std::printf("%-34s %12.0f %10lld %10lld %10lld %9s %7lld\n",
+        label.toUtf8().constData(),
+        json["opsPerSec"].toDouble(),
+        static_cast<long long>(json["p50Ns"].toInteger()),
+        static_cast<long long>(json["p99Ns"].toInteger()),
+        static_cast<long long>(json["p999Ns"].toInteger()),
+        allocs,
+        static_cast<long long>(json["errors"].toInteger()));
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    // Keep log I/O out of the measured paths
+    QLoggingCategory::setFilterRules(QStringLiteral("default.debug=false\nlogos.delivery.*=false"));
+
+    int iterations = 20000;
+    std::vector<int> threadCounts{1, 2, 4, 8};
+    bool jsonOutput = false;
+
+    const QStringList args = app.arguments();
+    for (qsizetype i = 1; i < args.size(); ++i) {
+        if (args[i] == "--iterations" && i + 1 < args.size()) {
+            iterations = std::max(1, args[++i].toInt());
+        } else if (args[i] == "--threads" && i + 1 < args.size()) {
+            threadCounts.clear();
+            for (const QString& count : args[++i].split(',', Qt::SkipEmptyParts)) {
+                threadCounts.push_back(std::max(1, count.toInt()));
+            }
+        } else if (args[i] == "--json") {
+            jsonOutput = true;
+        } else {
+            std::fprintf(stderr, "usage: %s [--iterations N] [--threads 1,2,4,8] [--json]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    DeliveryModulePlugin plugin;
+    if (!plugin.createNode(QStringLiteral("{\"mockLatencyUs\":0,\"mockCallbackThreads\":2}")) || !plugin.start()) {
+        std::fprintf(stderr, "failed to start the node; is the plugin linked against the mock library?\n");
+        return 1;
+    }
+
+    // Warm up every path once before measuring
+    benchSend(plugin, 1, std::min(iterations, 1000));
+    benchIngest(plugin, 1024, std::min(iterations, 1000));
+    benchRoundTrip(plugin, std::min(iterations, 1000));
+
+    QJsonArray results;
+    for (int threads : threadCounts) {
+        Result result = benchSend(plugin, threads, iterations);
+        results.append(toJson(result));
+    }
+    for (int payloadBytes : {64, 1024, 16 * 1024}) {
+        Result result = benchIngest(plugin, payloadBytes, iterations);
+        results.append(toJson(result));
+    }
+    {
+        Result result = benchRoundTrip(plugin, iterations);
+        results.append(toJson(result));
+    }
+    {
+        Result result = benchEmit(plugin, iterations);
+        results.append(toJson(result));
+    }
+
+    plugin.stop();
+
+    if (jsonOutput) {
+        QJsonObject report;
+        report["benchmark"] = "delivery_module_bench";
+        report["iterations"] = iterations;
+        report["results"] = results;
+        std::printf("%s\n", QJsonDocument(report).toJson(QJsonDocument::Indented).constData());
+    } else {
+        std::printf("%-34s %12s %10s %10s %10s %9s %7s\n",
+            "benchmark", "ops/s", "p50 ns", "p99 ns", "p999 ns", "allocs/op", "errors");
+        for (const QJsonValue& result : results) {
+            printText(result.toObject());
+        }
+    }
+    return 0;
+}
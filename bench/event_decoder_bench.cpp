@@ -0,0 +1,100 @@
+// Microbenchmark: single-pass event decoder vs. the former QJsonDocument path
+// used by DeliveryModulePlugin::event_callback for `message_received` events.
+#include <QByteArray>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <QVariantList>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../delivery_event_decoder.h"
+
+namespace {
+
+QByteArray makeReceivedEvent(int payloadBytes)
+{
+    QByteArray payload(payloadBytes, 'x');
+    for (int i = 0; i < payloadBytes; ++i) {
+        payload[i] = static_cast<char>(i * 31);
+    }
+    return QByteArray("{\"eventType\":\"message_received\",\"requestId\":\"\","
+                      "\"messageHash\":\"0x5f0a7c1d2e3b4a596877869504a3b2c1d0e0f1a2b3c4d5e6f708192a3b4c5d6e\","
+                      "\"message\":{\"payload\":\"")
+        + payload.toBase64()
+        + QByteArray("\",\"contentTopic\":\"/bench/1/events/proto\",\"meta\":\"\",\"version\":0,"
+                     "\"timestamp\":1712345678901234567,\"ephemeral\":false}}");
+}
+
+// The decode performed before the streaming decoder existed.
+QVariantList decodeWithQJson(const char* msg, size_t len)
+{
+    QString message = QString::fromUtf8(msg, static_cast<qsizetype>(len));
+    QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
+    QJsonObject jsonObj = doc.object();
+    QJsonObject msgObj = jsonObj["message"].toObject();
+    QVariantList eventData;
+    if (jsonObj["eventType"].toString() == "message_received") {
+        eventData << jsonObj["messageHash"].toString();
+        eventData << msgObj["contentTopic"].toString();
+        eventData << msgObj["payload"].toString();
+        eventData << QString::number(msgObj["timestamp"].toDouble(), 'f', 0);
+    }
+    return eventData;
+}
+
+QVariantList decodeStreaming(const char* msg, size_t len)
+{
+    DeliveryEventView event;
+    QVariantList eventData;
+    if (decodeDeliveryEvent(msg, len, event) && event.eventType == "message_received") {
+        auto field = [](std::string_view value) {
+            return QString::fromUtf8(value.data(), static_cast<qsizetype>(value.size()));
+        };
+        eventData << field(event.messageHash);
+        eventData << field(event.contentTopic);
+        eventData << field(event.payload);
+        eventData << QString::fromStdString(normalizeTimestamp(event.timestamp));
+    }
+    return eventData;
+}
+
+template <typename Decode>
+double nanosPerEvent(const QByteArray& event, int iterations, Decode decode)
+{
+    qsizetype sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sink += decode(event.constData(), static_cast<size_t>(event.size())).size();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if (sink != static_cast<qsizetype>(iterations) * 4) {
+        std::fprintf(stderr, "unexpected decode result\n");
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+} // namespace
+
+int main()
+{
+    const std::vector<int> payloadSizes{64, 1024, 16 * 1024, 128 * 1024};
+
+    std::printf("%-12s %-14s %-14s %-8s\n", "payload", "qjson ns/op", "stream ns/op", "speedup");
+    for (int payloadBytes : payloadSizes) {
+        const QByteArray event = makeReceivedEvent(payloadBytes);
+        const int iterations = payloadBytes >= 16 * 1024 ? 2000 : 50000;
+
+        // Warm up both paths before measuring
+        nanosPerEvent(event, iterations / 10, decodeWithQJson);
+        nanosPerEvent(event, iterations / 10, decodeStreaming);
+
+        const double qjson = nanosPerEvent(event, iterations, decodeWithQJson);
+        const double streaming = nanosPerEvent(event, iterations, decodeStreaming);
+        std::printf("%-12d %-14.0f %-14.0f %-8.2f\n", payloadBytes, qjson, streaming, qjson / streaming);
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <semaphore>
+#include "pending_call_table.h"
+
+/**
+ * @brief Lets another thread abandon a blocking FFI call.
+ *
+ * A caller blocked in `invokeAndWait` attaches its pending call; @ref cancel
+ * then cancels that PendingCallTable slot and, if it won the race against the
+ * callback, wakes the caller itself. Either the callback or the token releases
+ * the caller, never both. liblogosdelivery is not interrupted: the operation
+ * may still complete, its callback is just ignored.
+ *
+ * Cancellation is sticky, so a token cancelled before the call attaches makes
+ * the call return as soon as it has been initiated.
+ *
+ * A batch of calls waiting together attaches a function instead, which
+ * cancels whichever of its calls are still pending.
+ */
+class CancellationToken {
+public:
+    /**
+     * @return `false` if the token was already cancelled.
+     */
+    bool cancel()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_cancelled.exchange(true, std::memory_order_acq_rel)) {
+            return false;
+        }
+        if (m_key && m_table->cancel(m_key)) {
+            *m_cancelledFlag = true;
+            m_wake->release();
+        }
+        if (m_onCancel) {
+            m_onCancel();
+        }
+        return true;
+    }
+
+    bool isCancelled() const { return m_cancelled.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Registers a pending call to cancel.
+     * @param cancelledFlag Set to `true` before @p wake is released by @ref cancel.
+     * @return `false` if the token is already cancelled; nothing is attached then.
+     */
+    bool attach(PendingCallTable& table, void* key, std::binary_semaphore& wake, bool& cancelledFlag)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (isCancelled()) {
+            return false;
+        }
+        m_table = &table;
+        m_key = key;
+        m_wake = &wake;
+        m_cancelledFlag = &cancelledFlag;
+        return true;
+    }
+
+    /**
+     * @brief Registers a batch of pending calls; @p onCancel runs under the
+     * token's lock when @ref cancel is called.
+     * @return `false` if the token is already cancelled; nothing is attached then.
+     */
+    bool attach(std::function<void()> onCancel)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (isCancelled()) {
+            return false;
+        }
+        m_onCancel = std::move(onCancel);
+        return true;
+    }
+
+    /**
+     * @brief Unregisters the pending call; once this returns the token no longer touches it.
+     */
+    void detach()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_table = nullptr;
+        m_key = nullptr;
+        m_wake = nullptr;
+        m_cancelledFlag = nullptr;
+        m_onCancel = nullptr;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::atomic<bool> m_cancelled{false};
+    PendingCallTable* m_table{nullptr};
+    void* m_key{nullptr};
+    std::binary_semaphore* m_wake{nullptr};
+    bool* m_cancelledFlag{nullptr};
+    std::function<void()> m_onCancel;
+};
@@ -0,0 +1,343 @@
+#include "delivery_event_decoder.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+class Scanner {
+public:
+    Scanner(const char* data, size_t len) : m_pos(data), m_end(data + len) {}
+
+    bool atEnd()
+    {
+        skipWhitespace();
+        return m_pos == m_end;
+    }
+
+    bool consume(char expected)
+    {
+        skipWhitespace();
+        if (m_pos == m_end || *m_pos != expected) {
+            return false;
+        }
+        ++m_pos;
+        return true;
+    }
+
+    bool peek(char expected)
+    {
+        skipWhitespace();
+        return m_pos != m_end && *m_pos == expected;
+    }
+
+    // Reads a string token; the view excludes the quotes.
+    bool readString(std::string_view& value, bool& escaped)
+    {
+        if (!consume('"')) {
+            return false;
+        }
+        const char* start = m_pos;
+        escaped = false;
+        while (m_pos != m_end) {
+            const char c = *m_pos;
+            if (c == '"') {
+                value = std::string_view(start, static_cast<size_t>(m_pos - start));
+                ++m_pos;
+                return true;
+            }
+            if (c == '\\') {
+                escaped = true;
+                if (++m_pos == m_end) {
+                    return false;
+                }
+            }
+            ++m_pos;
+        }
+        return false;
+    }
+
+    bool readNumber(std::string_view& value)
+    {
+        skipWhitespace();
+        const char* start = m_pos;
+        while (m_pos != m_end) {
+            const char c = *m_pos;
+            if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+                ++m_pos;
+            } else {
+                break;
+            }
+        }
+        value = std::string_view(start, static_cast<size_t>(m_pos - start));
+        return !value.empty();
+    }
+
+    bool skipValue(int depth = 0)
+    {
+        if (depth > kMaxDepth) {
+            return false;
+        }
+        skipWhitespace();
+        if (m_pos == m_end) {
+            return false;
+        }
+        switch (*m_pos) {
+        case '"': {
+            std::string_view ignored;
+            bool escaped = false;
+            return readString(ignored, escaped);
+        }
+        case '{':
+        case '[': {
+            const char close = *m_pos == '{' ? '}' : ']';
+            const bool isObject = *m_pos == '{';
+            ++m_pos;
+            if (consume(close)) {
+                return true;
+            }
+            do {
+                if (isObject) {
+                    std::string_view key;
+                    bool escaped = false;
+                    if (!readString(key, escaped) || !consume(':')) {
+                        return false;
+                    }
+                }
+                if (!skipValue(depth + 1)) {
+                    return false;
+                }
+            } while (consume(','));
+            return consume(close);
+        }
+        default: {
+            // Number or literal (true / false / null)
+            const char* start = m_pos;
+            while (m_pos != m_end && *m_pos != ',' && *m_pos != '}' && *m_pos != ']'
+                   && *m_pos != ' ' && *m_pos != '\t' && *m_pos != '\n' && *m_pos != '\r') {
+                ++m_pos;
+            }
+            return m_pos != start;
+        }
+        }
+    }
+
+private:
+    static constexpr int kMaxDepth = 64;
+
+    void skipWhitespace()
+    {
+        while (m_pos != m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r')) {
+            ++m_pos;
+        }
+    }
+
+    const char* m_pos;
+    const char* m_end;
+};
+
+bool readField(Scanner& scanner, DeliveryEventView& out, std::string_view& target, DeliveryEventView::Field field)
+{
+    if (!scanner.peek('"')) {
+        // Not a string (e.g. null); keep the field absent
+        return scanner.skipValue();
+    }
+    bool escaped = false;
+    if (!scanner.readString(target, escaped)) {
+        return false;
+    }
+    out.presentFields |= field;
+    if (escaped) {
+        out.escapedFields |= field;
+    }
+    return true;
+}
+
+bool decodeMessage(Scanner& scanner, DeliveryEventView& out)
+{
+    if (!scanner.peek('{')) {
+        return scanner.skipValue();
+    }
+    scanner.consume('{');
+    if (scanner.consume('}')) {
+        return true;
+    }
+    do {
+        std::string_view key;
+        bool keyEscaped = false;
+        if (!scanner.readString(key, keyEscaped) || !scanner.consume(':')) {
+            return false;
+        }
+        bool ok = true;
+        if (key == "contentTopic") {
+            ok = readField(scanner, out, out.contentTopic, DeliveryEventView::ContentTopic);
+        } else if (key == "payload") {
+            ok = readField(scanner, out, out.payload, DeliveryEventView::Payload);
+        } else if (key == "timestamp" && !scanner.peek('"') && !scanner.peek('{') && !scanner.peek('[')) {
+            ok = scanner.readNumber(out.timestamp);
+            if (ok) {
+                out.presentFields |= DeliveryEventView::Timestamp;
+            }
+        } else {
+            ok = scanner.skipValue(1);
+        }
+        if (!ok) {
+            return false;
+        }
+    } while (scanner.consume(','));
+    return scanner.consume('}');
+}
+
+void appendUtf8(std::string& out, uint32_t codePoint)
+{
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+bool readHex4(std::string_view text, size_t pos, uint32_t& value)
+{
+    if (pos + 4 > text.size()) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = pos; i < pos + 4; ++i) {
+        const char c = text[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value |= static_cast<uint32_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            value |= static_cast<uint32_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            value |= static_cast<uint32_t>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool decodeDeliveryEvent(const char* data, size_t len, DeliveryEventView& out)
+{
+    out = DeliveryEventView{};
+    if (!data || len == 0) {
+        return false;
+    }
+
+    Scanner scanner(data, len);
+    if (!scanner.consume('{')) {
+        return false;
+    }
+    if (scanner.consume('}')) {
+        return scanner.atEnd();
+    }
+
+    do {
+        std::string_view key;
+        bool keyEscaped = false;
+        if (!scanner.readString(key, keyEscaped) || !scanner.consume(':')) {
+            return false;
+        }
+        bool ok = true;
+        if (key == "eventType") {
+            ok = readField(scanner, out, out.eventType, DeliveryEventView::EventType);
+        } else if (key == "requestId") {
+            ok = readField(scanner, out, out.requestId, DeliveryEventView::RequestId);
+        } else if (key == "messageHash") {
+            ok = readField(scanner, out, out.messageHash, DeliveryEventView::MessageHash);
+        } else if (key == "error") {
+            ok = readField(scanner, out, out.error, DeliveryEventView::Error);
+        } else if (key == "connectionStatus") {
+            ok = readField(scanner, out, out.connectionStatus, DeliveryEventView::ConnectionStatus);
+        } else if (key == "message") {
+            ok = decodeMessage(scanner, out);
+        } else {
+            ok = scanner.skipValue();
+        }
+        if (!ok) {
+            return false;
+        }
+    } while (scanner.consume(','));
+
+    return scanner.consume('}') && scanner.atEnd();
+}
+
+std::string unescapeJsonString(std::string_view escaped)
+{
+    std::string out;
+    out.reserve(escaped.size());
+    for (size_t i = 0; i < escaped.size(); ++i) {
+        const char c = escaped[i];
+        if (c != '\\' || i + 1 == escaped.size()) {
+            out.push_back(c);
+            continue;
+        }
+        const char next = escaped[++i];
+        switch (next) {
+        case 'b': out.push_back('\b'); break;
+        case 'f': out.push_back('\f'); break;
+        case 'n': out.push_back('\n'); break;
+        case 'r': out.push_back('\r'); break;
+        case 't': out.push_back('\t'); break;
+        case 'u': {
+            uint32_t codePoint = 0;
+            if (!readHex4(escaped, i + 1, codePoint)) {
+                out.push_back(next);
+                break;
+            }
+            i += 4;
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF && i + 2 < escaped.size()
+                && escaped[i + 1] == '\\' && escaped[i + 2] == 'u') {
+                uint32_t low = 0;
+                if (readHex4(escaped, i + 3, low) && low >= 0xDC00 && low <= 0xDFFF) {
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+            }
+            appendUtf8(out, codePoint);
+            break;
+        }
+        default:
+            // \" \\ \/ and anything unexpected map to the escaped character itself
+            out.push_back(next);
+            break;
+        }
+    }
+    return out;
+}
+
+std::string normalizeTimestamp(std::string_view number)
+{
+    bool integral = !number.empty();
+    for (size_t i = 0; i < number.size(); ++i) {
+        const char c = number[i];
+        if (!((c >= '0' && c <= '9') || (i == 0 && c == '-'))) {
+            integral = false;
+            break;
+        }
+    }
+    if (integral) {
+        return std::string(number);
+    }
+
+    const std::string text(number);
+    const double value = std::strtod(text.c_str(), nullptr);
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%.0f", std::isfinite(value) ? value : 0.0);
+    return buffer;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Fields of a liblogosdelivery event, as views into the raw event buffer.
+ *
+ * Views point at the characters between the JSON quotes (or at the number
+ * token for `timestamp`) and are only valid while the decoded buffer is alive.
+ * A field whose bit is set in @ref escapedFields contains JSON escape
+ * sequences and must go through @ref unescapeJsonString before use.
+ */
+struct DeliveryEventView {
+    enum Field : uint32_t {
+        EventType = 1u << 0,
+        RequestId = 1u << 1,
+        MessageHash = 1u << 2,
+        Error = 1u << 3,
+        ConnectionStatus = 1u << 4,
+        ContentTopic = 1u << 5,
+        Payload = 1u << 6,
+        Timestamp = 1u << 7,
+    };
+
+    std::string_view eventType;
+    std::string_view requestId;
+    std::string_view messageHash;
+    std::string_view error;
+    std::string_view connectionStatus;
+    std::string_view contentTopic; // message.contentTopic
+    std::string_view payload;      // message.payload (base64)
+    std::string_view timestamp;    // message.timestamp, raw number token
+
+    uint32_t presentFields{0};
+    uint32_t escapedFields{0};
+
+    bool has(Field field) const { return (presentFields & field) != 0; }
+    bool isEscaped(Field field) const { return (escapedFields & field) != 0; }
+};
+
+/**
+ * @brief Single-pass decoder for liblogosdelivery event JSON.
+ *
+ * Walks the buffer once, records views for the handful of fields the plugin
+ * emits and skips everything else without allocating. Unknown keys, nested
+ * values and whitespace are tolerated; structurally invalid JSON is rejected.
+ *
+ * @param data Raw UTF-8 event buffer.
+ * @param len Buffer length in bytes.
+ * @param out Receives the field views; reset before decoding.
+ * @return `true` if the buffer holds a well-formed JSON object.
+ */
+bool decodeDeliveryEvent(const char* data, size_t len, DeliveryEventView& out);
+
+/**
+ * @brief Resolves JSON escape sequences (including `\uXXXX` surrogate pairs) to UTF-8.
+ * @param escaped String contents as found between the JSON quotes.
+ */
+std::string unescapeJsonString(std::string_view escaped);
+
+/**
+ * @brief Normalizes a JSON number token to an integer string.
+ *
+ * Plain integer tokens are returned unchanged so nanosecond timestamps keep
+ * their full precision; fractional or exponent forms are rounded.
+ */
+std::string normalizeTimestamp(std::string_view number);
@@ -0,0 +1,108 @@
+#include "delivery_log.h"
+
+#include <QDebug>
+
+Q_LOGGING_CATEGORY(lcDelivery, "logos.delivery")
+
+namespace {
+int64_t steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
+bool DeliveryLogRateLimiter::allow(uint32_t& suppressed)
+{
+    if (m_perSecond == 0) {
+        suppressed = 0;
+        return true;
+    }
+
+    const int64_t now = steadyNowMs();
+    int64_t windowStart = m_windowStartMs.load(std::memory_order_relaxed);
+    if (now - windowStart >= 1000
+        && m_windowStartMs.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+        m_count.store(0, std::memory_order_relaxed);
+    }
+
+    if (m_count.fetch_add(1, std::memory_order_relaxed) < m_perSecond) {
+        suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool deliveryLogEnabled(int level)
+{
+    switch (level) {
+    case DELIVERY_LOG_LEVEL_DEBUG:
+        return lcDelivery().isDebugEnabled();
+    case DELIVERY_LOG_LEVEL_INFO:
+        return lcDelivery().isInfoEnabled();
+    case DELIVERY_LOG_LEVEL_WARNING:
+        return lcDelivery().isWarningEnabled();
+    case DELIVERY_LOG_LEVEL_CRITICAL:
+        return lcDelivery().isCriticalEnabled();
+    default:
+        return false;
+    }
+}
+
+DeliveryLogRecord::DeliveryLogRecord(int level, const char* operation, uint32_t suppressed)
+    : m_level(level)
+{
+    m_line.reserve(128);
+    m_line += QLatin1String("op=");
+    m_line += QLatin1String(operation);
+    if (suppressed > 0) {
+        field("suppressed", static_cast<qint64>(suppressed));
+    }
+}
+
+DeliveryLogRecord::~DeliveryLogRecord()
+{
+    switch (m_level) {
+    case DELIVERY_LOG_LEVEL_DEBUG:
+        qCDebug(lcDelivery).noquote() << m_line;
+        break;
+    case DELIVERY_LOG_LEVEL_INFO:
+        qCInfo(lcDelivery).noquote() << m_line;
+        break;
+    case DELIVERY_LOG_LEVEL_WARNING:
+        qCWarning(lcDelivery).noquote() << m_line;
+        break;
+    default:
+        qCCritical(lcDelivery).noquote() << m_line;
+        break;
+    }
+}
+
+DeliveryLogRecord& DeliveryLogRecord::latency(std::chrono::steady_clock::duration elapsed)
+{
+    return field("latencyUs", static_cast<qint64>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+}
+
+DeliveryLogRecord& DeliveryLogRecord::message(const QString& text)
+{
+    m_line += QLatin1String(" msg=\"");
+    m_line += text;
+    m_line += QLatin1Char('"');
+    return *this;
+}
+
+DeliveryLogRecord& DeliveryLogRecord::field(const char* key, const QString& value)
+{
+    m_line += QLatin1Char(' ');
+    m_line += QLatin1String(key);
+    m_line += QLatin1Char('=');
+    m_line += value;
+    return *this;
+}
+
+DeliveryLogRecord& DeliveryLogRecord::field(const char* key, qint64 value)
+{
+    return field(key, QString::number(value));
+}
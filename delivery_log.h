@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Structured, rate-limited logging for the module's hot paths.
+ *
+ * - Compile-time floor: statements below `DELIVERY_LOG_MIN_LEVEL` (set by the
+ *   `LOGOS_DELIVERY_MODULE_LOG_LEVEL` CMake cache variable) compile to nothing.
+ * - Lazy formatting: arguments are only evaluated once the level is enabled at
+ *   runtime for the `logos.delivery` category and the site's rate limit allows it.
+ * - Per-site rate limiting: every statement owns a limiter; suppressed lines are
+ *   counted and reported on the next line that gets through.
+ * - Structured fields: `op=<operation> key=value ...` on a single line.
+ *
+ * @code
+ * DELIVERY_LOG_DEBUG("send", .topic(contentTopic).requestId(id).latency(elapsed));
+ * DELIVERY_LOG_WARNING("send", .topic(contentTopic).message(outcome.error()));
+ * @endcode
+ */
+
+#define DELIVERY_LOG_LEVEL_DEBUG 0
+#define DELIVERY_LOG_LEVEL_INFO 1
+#define DELIVERY_LOG_LEVEL_WARNING 2
+#define DELIVERY_LOG_LEVEL_CRITICAL 3
+#define DELIVERY_LOG_LEVEL_OFF 4
+
+#ifndef DELIVERY_LOG_MIN_LEVEL
+#define DELIVERY_LOG_MIN_LEVEL DELIVERY_LOG_LEVEL_DEBUG
+#endif
+
+/**
+ * @brief Default number of lines a single log site may emit per second.
+ */
+#ifndef DELIVERY_LOG_DEFAULT_RATE
+#define DELIVERY_LOG_DEFAULT_RATE 20
+#endif
+
+Q_DECLARE_LOGGING_CATEGORY(lcDelivery)
+
+/**
+ * @brief Fixed-window limiter owned by one log statement.
+ */
+class DeliveryLogRateLimiter {
+public:
+    explicit DeliveryLogRateLimiter(uint32_t perSecond) : m_perSecond(perSecond) {}
+
+    /**
+     * @param suppressed Receives the number of lines dropped since the last allowed one.
+     * @return `true` if the caller may log now.
+     */
+    bool allow(uint32_t& suppressed);
+
+private:
+    const uint32_t m_perSecond;
+    std::atomic<int64_t> m_windowStartMs{0};
+    std::atomic<uint32_t> m_count{0};
+    std::atomic<uint32_t> m_suppressed{0};
+};
+
+/**
+ * @brief One structured log line, emitted when the record goes out of scope.
+ */
+class DeliveryLogRecord {
+public:
+    DeliveryLogRecord(int level, const char* operation, uint32_t suppressed);
+    ~DeliveryLogRecord();
+
+    DeliveryLogRecord(const DeliveryLogRecord&) = delete;
+    DeliveryLogRecord& operator=(const DeliveryLogRecord&) = delete;
+
+    DeliveryLogRecord& topic(const QString& contentTopic) { return field("topic", contentTopic); }
+    DeliveryLogRecord& requestId(const QString& id) { return field("requestId", id); }
+    DeliveryLogRecord& latency(std::chrono::steady_clock::duration elapsed);
+    DeliveryLogRecord& message(const QString& text);
+    DeliveryLogRecord& field(const char* key, const QString& value);
+    DeliveryLogRecord& field(const char* key, qint64 value);
+
+private:
+    const int m_level;
+    QString m_line;
+};
+
+/**
+ * @brief Runtime check for @p level on the `logos.delivery` category.
+ */
+bool deliveryLogEnabled(int level);
+
+#define DELIVERY_LOG_RATE(level, perSecond, operation, ...)                                      \
+    do {                                                                                         \
+        if constexpr ((level) >= DELIVERY_LOG_MIN_LEVEL) {                                       \
+            if (deliveryLogEnabled(level)) {                                                     \
+                static DeliveryLogRateLimiter deliveryLogLimiter_(perSecond);                    \
+                uint32_t deliveryLogSuppressed_ = 0;                                             \
+                if (deliveryLogLimiter_.allow(deliveryLogSuppressed_)) {                         \
+                    DeliveryLogRecord(level, operation, deliveryLogSuppressed_) __VA_ARGS__;     \
+                }                                                                                \
+            }                                                                                    \
+        }                                                                                        \
+    } while (0)
+
+#define DELIVERY_LOG_DEBUG(operation, ...) \
+    DELIVERY_LOG_RATE(DELIVERY_LOG_LEVEL_DEBUG, DELIVERY_LOG_DEFAULT_RATE, operation, __VA_ARGS__)
+#define DELIVERY_LOG_INFO(operation, ...) \
+    DELIVERY_LOG_RATE(DELIVERY_LOG_LEVEL_INFO, DELIVERY_LOG_DEFAULT_RATE, operation, __VA_ARGS__)
+#define DELIVERY_LOG_WARNING(operation, ...) \
+    DELIVERY_LOG_RATE(DELIVERY_LOG_LEVEL_WARNING, DELIVERY_LOG_DEFAULT_RATE, operation, __VA_ARGS__)
+#define DELIVERY_LOG_CRITICAL(operation, ...) \
+    DELIVERY_LOG_RATE(DELIVERY_LOG_LEVEL_CRITICAL, DELIVERY_LOG_DEFAULT_RATE, operation, __VA_ARGS__)
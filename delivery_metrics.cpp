@@ -0,0 +1,241 @@
+#include "delivery_metrics.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+constexpr size_t kEventDelivered = 0;
+constexpr size_t kEventUndelivered = 1;
+constexpr size_t kEventDropped = 2;
+
+uint64_t toNs(std::chrono::steady_clock::duration duration)
+{
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    return ns > 0 ? static_cast<uint64_t>(ns) : 0;
+}
+} // namespace
+
+const QString& ffiOperationName(FfiOperation operation)
+{
+    static const std::array<QString, static_cast<size_t>(FfiOperation::Count)> names{
+        QStringLiteral("create_node"),
+        QStringLiteral("start"),
+        QStringLiteral("stop"),
+        QStringLiteral("send"),
+        QStringLiteral("subscribe"),
+        QStringLiteral("unsubscribe"),
+        QStringLiteral("get_node_info"),
+        QStringLiteral("get_available_node_info_ids"),
+        QStringLiteral("get_available_configs"),
+    };
+    return names[static_cast<size_t>(operation)];
+}
+
+const QString& deliveryEventName(DeliveryEventType type)
+{
+    static const std::array<QString, static_cast<size_t>(DeliveryEventType::Count)> names{
+        QStringLiteral("messageSent"),
+        QStringLiteral("messageError"),
+        QStringLiteral("messagePropagated"),
+        QStringLiteral("messageReceived"),
+        QStringLiteral("messageReceivedBytes"),
+        QStringLiteral("connectionStateChanged"),
+        QStringLiteral("sendAccepted"),
+        QStringLiteral("sendRejected"),
+        QStringLiteral("transferProgress"),
+    };
+    return names[static_cast<size_t>(type)];
+}
+
+DeliveryMetrics& DeliveryMetrics::instance()
+{
+    static DeliveryMetrics metrics;
+    return metrics;
+}
+
+DeliveryMetrics::DeliveryMetrics()
+    : m_stripes(std::make_unique<Stripe[]>(kStripes))
+{
+}
+
+size_t DeliveryMetrics::bucketFor(uint64_t valueNs)
+{
+    constexpr uint64_t subBuckets = uint64_t{1} << kSubBucketBits;
+    if (valueNs < subBuckets) {
+        return static_cast<size_t>(valueNs);
+    }
+    const size_t exponent = static_cast<size_t>(std::bit_width(valueNs)) - 1;
+    if (exponent >= kMaxExponent) {
+        return kBuckets - 1;
+    }
+    const size_t shift = exponent - kSubBucketBits;
+    const size_t subBucket = static_cast<size_t>(valueNs >> shift) - subBuckets;
+    return ((exponent - kSubBucketBits + 1) << kSubBucketBits) + subBucket;
+}
+
+uint64_t DeliveryMetrics::bucketUpperBound(size_t bucket)
+{
+    constexpr size_t subBuckets = size_t{1} << kSubBucketBits;
+    if (bucket < subBuckets) {
+        return bucket;
+    }
+    const size_t shift = (bucket >> kSubBucketBits) - 1;
+    const uint64_t lower = static_cast<uint64_t>(subBuckets + (bucket & (subBuckets - 1))) << shift;
+    return lower + (uint64_t{1} << shift) - 1;
+}
+
+size_t DeliveryMetrics::stripeIndex()
+{
+    static std::atomic<size_t> nextStripe{0};
+    thread_local const size_t stripe = nextStripe.fetch_add(1, std::memory_order_relaxed) % kStripes;
+    return stripe;
+}
+
+void DeliveryMetrics::Series::recordLatency(uint64_t valueNs)
+{
+    buckets[bucketFor(valueNs)].fetch_add(1, std::memory_order_relaxed);
+    sumNs.fetch_add(valueNs, std::memory_order_relaxed);
+    uint64_t currentMax = maxNs.load(std::memory_order_relaxed);
+    while (valueNs > currentMax
+           && !maxNs.compare_exchange_weak(currentMax, valueNs, std::memory_order_relaxed)) {
+    }
+}
+
+void DeliveryMetrics::recordCall(FfiOperation operation, CallOutcome outcome, std::chrono::steady_clock::duration latency)
+{
+    Series& series = m_stripes[stripeIndex()].operations[static_cast<size_t>(operation)];
+    series.counters[static_cast<size_t>(outcome)].fetch_add(1, std::memory_order_relaxed);
+    if (outcome == CallOutcome::Ok || outcome == CallOutcome::Failed) {
+        series.recordLatency(toNs(latency));
+    }
+}
+
+void DeliveryMetrics::recordEvent(DeliveryEventType type, std::chrono::steady_clock::duration latency, bool delivered)
+{
+    Series& series = m_stripes[stripeIndex()].events[static_cast<size_t>(type)];
+    series.counters[delivered ? kEventDelivered : kEventUndelivered].fetch_add(1, std::memory_order_relaxed);
+    series.recordLatency(toNs(latency));
+}
+
+void DeliveryMetrics::recordDroppedEvent(DeliveryEventType type)
+{
+    m_stripes[stripeIndex()].events[static_cast<size_t>(type)].counters[kEventDropped].fetch_add(1, std::memory_order_relaxed);
+}
+
+void DeliveryMetrics::recordDelivery(DeliveryStage stage, std::chrono::steady_clock::duration latency)
+{
+    m_stripes[stripeIndex()].delivery[static_cast<size_t>(stage)].recordLatency(toNs(latency));
+}
+
+QJsonObject DeliveryMetrics::latencyJson(const std::array<uint64_t, kBuckets>& buckets, uint64_t sumNs, uint64_t maxNs)
+{
+    uint64_t count = 0;
+    for (uint64_t bucketCount : buckets) {
+        count += bucketCount;
+    }
+
+    // Quantiles report the upper bound of the bucket they fall into
+    auto quantile = [&](double fraction) -> qint64 {
+        if (count == 0) {
+            return 0;
+        }
+        const uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(count - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+            seen += buckets[bucket];
+            if (seen >= rank) {
+                return static_cast<qint64>(std::min(bucketUpperBound(bucket), maxNs));
+            }
+        }
+        return static_cast<qint64>(maxNs);
+    };
+
+    QJsonObject latency;
+    latency["count"] = static_cast<qint64>(count);
+    latency["mean"] = count ? static_cast<qint64>(sumNs / count) : 0;
+    latency["max"] = static_cast<qint64>(maxNs);
+    latency["p50"] = quantile(0.50);
+    latency["p90"] = quantile(0.90);
+    latency["p99"] = quantile(0.99);
+    latency["p999"] = quantile(0.999);
+    return latency;
+}
+
+QJsonObject DeliveryMetrics::toJson() const
+{
+    struct Totals {
+        std::array<uint64_t, kCounters> counters{};
+        std::array<uint64_t, kBuckets> buckets{};
+        uint64_t sumNs{0};
+        uint64_t maxNs{0};
+
+        void add(const Series& series)
+        {
+            for (size_t i = 0; i < kCounters; ++i) {
+                counters[i] += series.counters[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < kBuckets; ++i) {
+                buckets[i] += series.buckets[i].load(std::memory_order_relaxed);
+            }
+            sumNs += series.sumNs.load(std::memory_order_relaxed);
+            maxNs = std::max(maxNs, series.maxNs.load(std::memory_order_relaxed));
+        }
+    };
+
+    QJsonObject operations;
+    for (size_t op = 0; op < kOperations; ++op) {
+        Totals totals;
+        for (size_t stripe = 0; stripe < kStripes; ++stripe) {
+            totals.add(m_stripes[stripe].operations[op]);
+        }
+        const auto count = [&](CallOutcome outcome) {
+            return static_cast<qint64>(totals.counters[static_cast<size_t>(outcome)]);
+        };
+        QJsonObject entry;
+        entry["calls"] = count(CallOutcome::Ok) + count(CallOutcome::Failed)
+            + count(CallOutcome::Timeout) + count(CallOutcome::NotInitiated) + count(CallOutcome::Cancelled);
+        entry["ok"] = count(CallOutcome::Ok);
+        entry["failed"] = count(CallOutcome::Failed);
+        entry["timeouts"] = count(CallOutcome::Timeout);
+        entry["notInitiated"] = count(CallOutcome::NotInitiated);
+        entry["cancelled"] = count(CallOutcome::Cancelled);
+        entry["latencyNs"] = latencyJson(totals.buckets, totals.sumNs, totals.maxNs);
+        operations[ffiOperationName(static_cast<FfiOperation>(op))] = entry;
+    }
+
+    QJsonObject events;
+    for (size_t type = 0; type < kEvents; ++type) {
+        Totals totals;
+        for (size_t stripe = 0; stripe < kStripes; ++stripe) {
+            totals.add(m_stripes[stripe].events[type]);
+        }
+        QJsonObject entry;
+        entry["emitted"] = static_cast<qint64>(totals.counters[kEventDelivered]);
+        entry["undelivered"] = static_cast<qint64>(totals.counters[kEventUndelivered]);
+        entry["dropped"] = static_cast<qint64>(totals.counters[kEventDropped]);
+        entry["latencyNs"] = latencyJson(totals.buckets, totals.sumNs, totals.maxNs);
+        events[deliveryEventName(static_cast<DeliveryEventType>(type))] = entry;
+    }
+
+    static const std::array<QString, kStages> stageNames{
+        QStringLiteral("propagated"),
+        QStringLiteral("sent"),
+        QStringLiteral("error"),
+    };
+    QJsonObject delivery;
+    for (size_t stage = 0; stage < kStages; ++stage) {
+        Totals totals;
+        for (size_t stripe = 0; stripe < kStripes; ++stripe) {
+            totals.add(m_stripes[stripe].delivery[stage]);
+        }
+        QJsonObject entry;
+        entry["latencyNs"] = latencyJson(totals.buckets, totals.sumNs, totals.maxNs);
+        delivery[stageNames[stage]] = entry;
+    }
+
+    QJsonObject metrics;
+    metrics["operations"] = operations;
+    metrics["events"] = events;
+    metrics["delivery"] = delivery;
+    return metrics;
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief liblogosdelivery calls issued through the API call handler.
+ */
+enum class FfiOperation : uint8_t {
+    CreateNode,
+    Start,
+    Stop,
+    Send,
+    Subscribe,
+    Unsubscribe,
+    GetNodeInfo,
+    GetAvailableNodeInfoIds,
+    GetAvailableConfigs,
+    Count
+};
+
+/**
+ * @brief Events the plugin emits to Logos API clients.
+ */
+enum class DeliveryEventType : uint8_t {
+    MessageSent,
+    MessageError,
+    MessagePropagated,
+    MessageReceived,
+    MessageReceivedBytes,
+    ConnectionStateChanged,
+    SendAccepted,
+    SendRejected,
+    TransferProgress,
+    Count
+};
+
+/**
+ * @brief Milestones of a sent message, measured from its `send` call.
+ */
+enum class DeliveryStage : uint8_t {
+    Propagated, ///< `message_propagated` received.
+    Sent,       ///< `message_sent` received.
+    Error,      ///< `message_error` received.
+    Count
+};
+
+/**
+ * @brief How a single FFI call ended.
+ */
+enum class CallOutcome : uint8_t {
+    Ok,           ///< Callback reported `RET_OK`.
+    Failed,       ///< Callback reported an error.
+    Timeout,      ///< No callback before the deadline.
+    NotInitiated, ///< The call could not be started.
+    Cancelled,    ///< The caller cancelled the wait before the callback.
+};
+
+/**
+ * @brief FFI operation name as used in error messages and metrics (e.g. `get_node_info`).
+ */
+const QString& ffiOperationName(FfiOperation operation);
+
+/**
+ * @brief Event name as emitted to clients (e.g. `messageSent`).
+ */
+const QString& deliveryEventName(DeliveryEventType type);
+
+/**
+ * @brief Process-wide counters and latency histograms for FFI calls and emitted events.
+ *
+ * Recording never locks or allocates: every series is split into stripes that
+ * threads pick once, so concurrent writers rarely share a cache line, and
+ * each stripe is updated with relaxed atomics. Latencies go into log-linear
+ * histograms (8 sub-buckets per power of two, i.e. at most 12.5% relative
+ * error) covering 1 ns to ~137 s; larger values land in the last bucket.
+ * Snapshots sum the stripes and are only approximately consistent while
+ * writers are active.
+ */
+class DeliveryMetrics {
+public:
+    static DeliveryMetrics& instance();
+
+    DeliveryMetrics();
+    DeliveryMetrics(const DeliveryMetrics&) = delete;
+    DeliveryMetrics& operator=(const DeliveryMetrics&) = delete;
+
+    /**
+     * @param latency Time from initiation to callback; ignored for calls that never completed.
+     */
+    void recordCall(FfiOperation operation, CallOutcome outcome, std::chrono::steady_clock::duration latency);
+
+    /**
+     * @param latency Time from ingestion (FFI callback or completion) to emission.
+     * @param delivered `false` if no Logos API client was available to receive it.
+     */
+    void recordEvent(DeliveryEventType type, std::chrono::steady_clock::duration latency, bool delivered);
+
+    /**
+     * @brief Counts an event lost because the dispatcher's event queue was full.
+     */
+    void recordDroppedEvent(DeliveryEventType type);
+
+    /**
+     * @param latency Time from the `send` call to @p stage.
+     */
+    void recordDelivery(DeliveryStage stage, std::chrono::steady_clock::duration latency);
+
+    /**
+     * @brief Snapshot as `{"operations": {...}, "events": {...}, "delivery": {...}}`.
+     *
+     * Each operation reports `calls`, `ok`, `failed`, `timeouts`,
+     * `notInitiated`, `cancelled` and `latencyNs`; each event reports `emitted`,
+     * `undelivered`, `dropped` and `latencyNs`; each delivery stage (`propagated`,
+     * `sent`, `error`) reports `latencyNs`. `latencyNs` holds `count`, `mean`,
+     * `max`, `p50`, `p90`, `p99` and `p999`.
+     */
+    QJsonObject toJson() const;
+
+    static constexpr size_t kSubBucketBits = 3;
+    static constexpr size_t kMaxExponent = 37;
+    static constexpr size_t kBuckets = (kMaxExponent - kSubBucketBits + 1) << kSubBucketBits;
+
+    /**
+     * @brief Histogram bucket holding @p valueNs.
+     */
+    static size_t bucketFor(uint64_t valueNs);
+
+    /**
+     * @brief Largest value that falls into @p bucket.
+     */
+    static uint64_t bucketUpperBound(size_t bucket);
+
+private:
+    static constexpr size_t kStripes = 8;
+    static constexpr size_t kOperations = static_cast<size_t>(FfiOperation::Count);
+    static constexpr size_t kEvents = static_cast<size_t>(DeliveryEventType::Count);
+    static constexpr size_t kStages = static_cast<size_t>(DeliveryStage::Count);
+    static constexpr size_t kCounters = 5;
+
+    struct alignas(64) Series {
+        std::array<std::atomic<uint64_t>, kCounters> counters{};
+        std::atomic<uint64_t> sumNs{0};
+        std::atomic<uint64_t> maxNs{0};
+        std::array<std::atomic<uint64_t>, kBuckets> buckets{};
+
+        void recordLatency(uint64_t valueNs);
+    };
+
+    struct Stripe {
+        std::array<Series, kOperations> operations;
+        std::array<Series, kEvents> events;
+        std::array<Series, kStages> delivery;
+    };
+
+    static size_t stripeIndex();
+    static QJsonObject latencyJson(const std::array<uint64_t, kBuckets>& buckets, uint64_t sumNs, uint64_t maxNs);
+
+    std::unique_ptr<Stripe[]> m_stripes;
+};
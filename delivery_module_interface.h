@@ -11,12 +11,24 @@ public:
     Q_INVOKABLE virtual bool createNode(const QString &cfg) = 0;
     Q_INVOKABLE virtual bool start() = 0;
     Q_INVOKABLE virtual bool stop() = 0;
+    Q_INVOKABLE virtual QExpected<QString> bootstrap(const QString &cfg, const QStringList &contentTopics) = 0;
     Q_INVOKABLE virtual QExpected<QString> send(const QString &contentTopic, const QString &payload) = 0;
+    Q_INVOKABLE virtual QExpected<QString> sendBytes(const QString &contentTopic, const QByteArray &payload) = 0;
+    Q_INVOKABLE virtual QExpected<QString> sendAsync(const QString &contentTopic, const QString &payload) = 0;
+    Q_INVOKABLE virtual QExpected<QString> sendWithDeadline(const QString &contentTopic, const QString &payload, int timeoutMs, const QString &cancelToken) = 0;
+    Q_INVOKABLE virtual bool cancelCall(const QString &cancelToken) = 0;
+    Q_INVOKABLE virtual QExpected<QVariantList> sendBatch(const QVariantList &messages) = 0;
     Q_INVOKABLE virtual bool subscribe(const QString &contentTopic) = 0;
     Q_INVOKABLE virtual bool unsubscribe(const QString &contentTopic) = 0;
+    Q_INVOKABLE virtual bool addTopicRoute(const QString &contentTopic, const QString &clientName) = 0;
+    Q_INVOKABLE virtual bool removeTopicRoute(const QString &contentTopic, const QString &clientName) = 0;
+    Q_INVOKABLE virtual QExpected<QVariantList> subscribeMany(const QStringList &contentTopics) = 0;
+    Q_INVOKABLE virtual QExpected<QVariantList> unsubscribeMany(const QStringList &contentTopics) = 0;
+    Q_INVOKABLE virtual QExpected<QVariantList> queryReceived(const QString &contentTopic, qint64 sinceNs, int limit) = 0;
     Q_INVOKABLE virtual QString getAvailableNodeInfoIDs() = 0;
     Q_INVOKABLE virtual QString getNodeInfo(const QString &nodeInfoId) = 0;
     Q_INVOKABLE virtual QString getAvailableConfigs() = 0;
+    Q_INVOKABLE virtual QString getMetrics() = 0;
 
 signals:
     void eventResponse(const QString& eventName, const QVariantList& data);
@@ -1,142 +1,569 @@
 #include "delivery_module_plugin.h"
-#include <QDebug>
 #include <QVariantList>
 #include <QDateTime>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <algorithm>
 #include <semaphore>
 
 #include "api_call_handler.h"
+#include "base64_codec.h"
+#include "delivery_event_decoder.h"
+#include "delivery_log.h"
 // Include the liblogosdelivery header from logos-delivery
 // liblogosdelivery provides a high-level message-delivery API
 extern "C" {
 #include <liblogosdelivery.h>
 }
 
+namespace {
+// Appends @p value as a quoted JSON string, escaping only what JSON requires.
+void appendJsonString(QByteArray& out, const QByteArray& value)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    out.append('"');
+    for (char c : value) {
+        const auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out.append('\\').append(c);
+        } else if (byte < 0x20) {
+            out.append("\\u00").append(hexDigits[byte >> 4]).append(hexDigits[byte & 0x0f]);
+        } else {
+            out.append(c);
+        }
+    }
+    out.append('"');
+}
+
+// Node info ids share the cache with other queries, hence the prefix.
+QString nodeInfoCacheKey(const QString& nodeInfoId)
+{
+    return QStringLiteral("node_info:") + nodeInfoId;
+}
+
+std::string_view utf8View(const QByteArray& utf8)
+{
+    return std::string_view(utf8.constData(), static_cast<size_t>(utf8.size()));
+}
+
+// Materializes one decoded event field, resolving JSON escapes only when present.
+QString eventField(const DeliveryEventView& event, std::string_view value, DeliveryEventView::Field field)
+{
+    if (event.isEscaped(field)) {
+        const std::string unescaped = unescapeJsonString(value);
+        return QString::fromUtf8(unescaped.data(), static_cast<qsizetype>(unescaped.size()));
+    }
+    return QString::fromUtf8(value.data(), static_cast<qsizetype>(value.size()));
+}
+
+// Top-level keys of a node config; the values are never logged since they may hold the node key
+QString configKeys(const QString& cfg)
+{
+    return QJsonDocument::fromJson(cfg.toUtf8()).object().keys().join(QLatin1Char(','));
+}
+} // namespace
+
 DeliveryModulePlugin::DeliveryModulePlugin() : deliveryCtx(nullptr)
 {
-    qDebug() << "DeliveryModulePlugin: Initializing...";
-    qDebug() << "DeliveryModulePlugin: Initialized successfully";
+    inflightTracker.setRetireHandler([this](uint64_t admissionKey, std::chrono::steady_clock::duration age) {
+        sendAdmission.release(admissionKey, age);
+    });
 }
 
 DeliveryModulePlugin::~DeliveryModulePlugin() 
 {
+    // No event may reach the Logos API once it is gone
+    stopEventDispatcher();
+    // Pending sendAsync completions touch this plugin; settle them while it is alive
+    asyncCalls.cancelAll();
+
     // Clean up resources, this is not done in PluginInterface destructor
     if (logosAPI) {
+        deliveryClient = nullptr;
+        routedClients.clear();
         delete logosAPI;
         logosAPI = nullptr;
     }
     
-    // Clean up delivery context if it exists
-    if (deliveryCtx) {
-        logosdelivery_destroy(deliveryCtx, nullptr, nullptr);
-        deliveryCtx = nullptr;
+    // Clean up every delivery context of the pool
+    std::unique_lock<std::shared_mutex> contextLock(contextMutex);
+    for (void* ctx : nodePool.release()) {
+        logosdelivery_destroy(ctx, nullptr, nullptr);
     }
+    deliveryCtx = nullptr;
 }
 
-void DeliveryModulePlugin::emitEvent(const QString& eventName, const QVariantList& data) {
+void DeliveryModulePlugin::emitEvent(DeliveryEventType type, const QVariantList& data, std::chrono::steady_clock::time_point enqueuedAt,
+    const QStringList& clients) {
+    const QString& eventName = deliveryEventName(type);
+    std::lock_guard<std::mutex> lock(logosApiMutex);
     if (!logosAPI) {
-        qWarning() << "DeliveryModulePlugin: LogosAPI not available, cannot emit" << eventName;
+        DeliveryMetrics::instance().recordEvent(type, std::chrono::steady_clock::now() - enqueuedAt, false);
+        DELIVERY_LOG_WARNING("emitEvent", .field("event", eventName).message("LogosAPI not available"));
+        return;
+    }
+
+    if (!clients.isEmpty()) {
+        bool delivered = false;
+        for (const QString& clientName : clients) {
+            LogosAPIClient*& client = routedClients[clientName];
+            if (!client) {
+                client = resolveClient(clientName);
+            }
+            if (!client) {
+                DELIVERY_LOG_WARNING("emitEvent", .field("event", eventName).field("client", clientName)
+                    .message("routed client not available"));
+                continue;
+            }
+            client->onEventResponse(this, eventName, data);
+            delivered = true;
+        }
+        DeliveryMetrics::instance().recordEvent(type, std::chrono::steady_clock::now() - enqueuedAt, delivered);
         return;
     }
 
-    LogosAPIClient* client = logosAPI->getClient("delivery_module");
-    if (!client) {
-        qWarning() << "DeliveryModulePlugin: Failed to get delivery_module client for event" << eventName;
+    // Normally resolved by initLogos; retried here only if that lookup failed
+    if (!deliveryClient) {
+        deliveryClient = resolveClient(name());
+    }
+    if (!deliveryClient) {
+        DeliveryMetrics::instance().recordEvent(type, std::chrono::steady_clock::now() - enqueuedAt, false);
+        DELIVERY_LOG_WARNING("emitEvent", .field("event", eventName).message("delivery_module client not available"));
         return;
     }
 
-    client->onEventResponse(this, eventName, data);
+    deliveryClient->onEventResponse(this, eventName, data);
+    DeliveryMetrics::instance().recordEvent(type, std::chrono::steady_clock::now() - enqueuedAt, true);
+}
+
+LogosAPIClient* DeliveryModulePlugin::resolveClient(const QString& clientName) {
+    clientLookups.fetch_add(1, std::memory_order_relaxed);
+    return logosAPI->getClient(clientName);
 }
 
 // Static callback function for liblogosdelivery events, this one is one time registered
 // on initialization and will be called for all events from the Nim FFI side.
+// It runs on the liblogosdelivery thread, so it only copies the event for the dispatcher.
 void DeliveryModulePlugin::event_callback(int callerRet, const char* msg, size_t len, void* userData)
 {
-    qDebug() << "DeliveryModulePlugin::event_callback called with ret:" << callerRet;
+    Q_UNUSED(callerRet);
 
     DeliveryModulePlugin* plugin = static_cast<DeliveryModulePlugin*>(userData);
     if (!plugin) {
-        qWarning() << "DeliveryModulePlugin::event_callback: Invalid userData";
+        DELIVERY_LOG_WARNING("event", .message("invalid userData"));
         return;
     }
 
     if (msg && len > 0) {
-        QString message = QString::fromUtf8(msg, len);
-        qDebug() << "DeliveryModulePlugin::event_callback message:" << message;
-        
-        // Parse JSON to determine event type
-        QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
-        if (!doc.isObject()) {
-            qWarning() << "DeliveryModulePlugin::event_callback: Invalid JSON";
+        QueuedEvent event;
+        event.raw = QByteArray(msg, static_cast<qsizetype>(len));
+        event.receivedAtMs = QDateTime::currentMSecsSinceEpoch();
+        event.enqueuedAt = std::chrono::steady_clock::now();
+        plugin->enqueueEvent(std::move(event));
+    }
+}
+
+bool DeliveryModulePlugin::enqueueEvent(QueuedEvent&& event)
+{
+    if (!eventQueue.tryPush(std::move(event))) {
+        // tryPush leaves the event untouched on failure; raw events are only
+        // decoded on this path, so a full ring costs nothing extra otherwise
+        std::optional<DeliveryEventType> type;
+        if (event.raw.isEmpty()) {
+            type = event.type;
+        } else if (DeliveryEventView view; decodeDeliveryEvent(event.raw.constData(), static_cast<size_t>(event.raw.size()), view)) {
+            using PayloadFormat = DeliveryModuleOptions::ReceivedPayloadFormat;
+            if (view.eventType == "message_sent") {
+                type = DeliveryEventType::MessageSent;
+            } else if (view.eventType == "message_error") {
+                type = DeliveryEventType::MessageError;
+            } else if (view.eventType == "message_propagated") {
+                type = DeliveryEventType::MessagePropagated;
+            } else if (view.eventType == "message_received") {
+                type = receivedPayloadFormat.load(std::memory_order_relaxed) == PayloadFormat::Bytes
+                    ? DeliveryEventType::MessageReceivedBytes
+                    : DeliveryEventType::MessageReceived;
+            } else if (view.eventType == "connection_status_change") {
+                type = DeliveryEventType::ConnectionStateChanged;
+            }
+        }
+        if (type) {
+            DeliveryMetrics::instance().recordDroppedEvent(*type);
+        }
+        DELIVERY_LOG_WARNING("event_ring", .field("eventType", type ? deliveryEventName(*type) : QStringLiteral("unknown"))
+            .field("capacity", static_cast<qint64>(EVENT_QUEUE_CAPACITY))
+            .message("event queue full, event dropped"));
+        return false;
+    }
+    eventsAvailable.release();
+    return true;
+}
+
+void DeliveryModulePlugin::startEventDispatcher()
+{
+    if (dispatcherRunning.exchange(true)) {
+        return;
+    }
+    eventDispatcher = std::thread(&DeliveryModulePlugin::dispatchEvents, this);
+}
+
+void DeliveryModulePlugin::stopEventDispatcher()
+{
+    if (!dispatcherRunning.exchange(false)) {
+        return;
+    }
+    eventsAvailable.release();
+    if (eventDispatcher.joinable()) {
+        eventDispatcher.join();
+    }
+}
+
+void DeliveryModulePlugin::dispatchEvents()
+{
+    QueuedEvent event;
+    auto nextSweep = std::chrono::steady_clock::now() + INFLIGHT_SWEEP_INTERVAL;
+    while (true) {
+        // Wake up at least once per sweep interval, even without events
+        static_cast<void>(eventsAvailable.try_acquire_until(nextSweep));
+        if (!dispatcherRunning.load()) {
             return;
         }
-        
-        QJsonObject jsonObj = doc.object();
-        QString eventType = jsonObj["eventType"].toString();
-        QString timestamp = QDateTime::currentDateTime().toString(Qt::ISODate);
-        
-        if (eventType == "message_sent") {
-            // MessageSentEvent: requestId, messageHash
-            QVariantList eventData;
-            eventData << jsonObj["requestId"].toString();
-            eventData << jsonObj["messageHash"].toString();
-            eventData << timestamp;
-            plugin->emitEvent("messageSent", eventData);
-            
-        } else if (eventType == "message_error") {
-            // MessageErrorEvent: requestId, messageHash, error
-            QVariantList eventData;
-            eventData << jsonObj["requestId"].toString();
-            eventData << jsonObj["messageHash"].toString();
-            eventData << jsonObj["error"].toString();
-            eventData << timestamp;
-            plugin->emitEvent("messageError", eventData);
-            
-        } else if (eventType == "message_propagated") {
-            // MessagePropagatedEvent: requestId, messageHash
+        while (eventQueue.tryPop(event)) {
+            if (!event.raw.isEmpty()) {
+                handleRawEvent(event);
+            } else {
+                event.data << QDateTime::fromMSecsSinceEpoch(event.receivedAtMs).toString(Qt::ISODate);
+                emitEvent(event.type, event.data, event.enqueuedAt);
+            }
+            event = QueuedEvent{};
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= nextSweep) {
+            inflightTracker.expire(now);
+            payloadChunker.expire(now);
+            if (const size_t expired = asyncCalls.expire(now)) {
+                DELIVERY_LOG_WARNING("sendAsync", .field("expired", static_cast<qint64>(expired))
+                    .message("no acknowledgement before the call timeout"));
+            }
+            nextSweep = now + INFLIGHT_SWEEP_INTERVAL;
+        }
+    }
+}
+
+void DeliveryModulePlugin::handleRawEvent(const QueuedEvent& queued)
+{
+    const QByteArray& message = queued.raw;
+    const qint64 receivedAtMs = queued.receivedAtMs;
+    const auto enqueuedAt = queued.enqueuedAt;
+
+    // Single pass over the raw buffer; only emitted fields become QStrings
+    DeliveryEventView event;
+    if (!decodeDeliveryEvent(message.constData(), static_cast<size_t>(message.size()), event)) {
+        DELIVERY_LOG_WARNING("event", .field("bytes", static_cast<qint64>(message.size())).message("invalid JSON"));
+        return;
+    }
+
+    const std::string_view eventType = event.eventType;
+    auto timestamp = [receivedAtMs]() {
+        return QDateTime::fromMSecsSinceEpoch(receivedAtMs).toString(Qt::ISODate);
+    };
+    // Request id as the in-flight table keys it; escapes are practically never present
+    auto trackedRequestId = [&event](std::string& storage) {
+        if (!event.isEscaped(DeliveryEventView::RequestId)) {
+            return event.requestId;
+        }
+        storage = unescapeJsonString(event.requestId);
+        return std::string_view(storage);
+    };
+    std::string requestIdStorage;
+
+    if (eventType == "message_sent") {
+        // MessageSentEvent: requestId, messageHash
+        QVariantList eventData;
+        eventData << eventField(event, event.requestId, DeliveryEventView::RequestId);
+        eventData << eventField(event, event.messageHash, DeliveryEventView::MessageHash);
+        eventData << timestamp();
+        const std::string_view requestId = trackedRequestId(requestIdStorage);
+        inflightTracker.sent(requestId, enqueuedAt);
+        outboundJournal.retireRequest(requestId);
+        emitEvent(DeliveryEventType::MessageSent, eventData, enqueuedAt);
+
+    } else if (eventType == "message_error") {
+        // MessageErrorEvent: requestId, messageHash, error
+        QVariantList eventData;
+        eventData << eventField(event, event.requestId, DeliveryEventView::RequestId);
+        eventData << eventField(event, event.messageHash, DeliveryEventView::MessageHash);
+        eventData << eventField(event, event.error, DeliveryEventView::Error);
+        eventData << timestamp();
+        const std::string_view requestId = trackedRequestId(requestIdStorage);
+        inflightTracker.failed(requestId, enqueuedAt);
+        outboundJournal.retireRequest(requestId);
+        emitEvent(DeliveryEventType::MessageError, eventData, enqueuedAt);
+
+    } else if (eventType == "message_propagated") {
+        // MessagePropagatedEvent: requestId, messageHash
+        QVariantList eventData;
+        eventData << eventField(event, event.requestId, DeliveryEventView::RequestId);
+        eventData << eventField(event, event.messageHash, DeliveryEventView::MessageHash);
+        eventData << timestamp();
+        inflightTracker.propagated(trackedRequestId(requestIdStorage), enqueuedAt);
+        emitEvent(DeliveryEventType::MessagePropagated, eventData, enqueuedAt);
+
+    } else if (eventType == "message_received") {
+        // MessageReceivedEvent: messageHash, message (WakuMessage)
+        if (receivedDedup.isDuplicate(event.messageHash, enqueuedAt)) {
+            DELIVERY_LOG_DEBUG("event", .field("messageHash", eventField(event, event.messageHash, DeliveryEventView::MessageHash))
+                .message("duplicate message dropped"));
+            return;
+        }
+        using PayloadFormat = DeliveryModuleOptions::ReceivedPayloadFormat;
+        const PayloadFormat payloadFormat = receivedPayloadFormat.load(std::memory_order_relaxed);
+        const QString messageHash = eventField(event, event.messageHash, DeliveryEventView::MessageHash);
+        const QString contentTopic = eventField(event, event.contentTopic, DeliveryEventView::ContentTopic);
+        const QString messageTimestamp = event.has(DeliveryEventView::Timestamp)
+            ? QString::fromStdString(normalizeTimestamp(event.timestamp))
+            : QStringLiteral("0");
+        const QStringList routes = event.isEscaped(DeliveryEventView::ContentTopic)
+            ? topicRouter.clientsFor(utf8View(contentTopic.toUtf8()))
+            : topicRouter.clientsFor(event.contentTopic);
+
+        // Read straight from the raw buffer; base64 only needs unescaping if a peer escaped it anyway
+        const std::string unescapedPayload = event.isEscaped(DeliveryEventView::Payload)
+            ? unescapeJsonString(event.payload)
+            : std::string();
+        std::string_view encodedPayload = unescapedPayload.empty() ? event.payload : std::string_view(unescapedPayload);
+
+        // Chunks are held back until their transfer completes, which then goes on as one message
+        QByteArray reassembled;
+        if (PayloadChunker::isChunkBase64(encodedPayload)) {
+            const PayloadChunker::Outcome chunk = payloadChunker.add(contentTopic.toUtf8(), decodeBase64(encodedPayload), enqueuedAt);
+            if (chunk.status == PayloadChunker::Status::Progress) {
+                QVariantList eventData;
+                eventData << QString::fromLatin1(chunk.transferId.toHex()) << contentTopic;
+                eventData << static_cast<qint64>(chunk.receivedChunks) << static_cast<qint64>(chunk.totalChunks);
+                eventData << static_cast<qint64>(chunk.receivedBytes) << static_cast<qint64>(chunk.totalBytes);
+                emitEvent(DeliveryEventType::TransferProgress, eventData, enqueuedAt, routes);
+                return;
+            }
+            if (chunk.status == PayloadChunker::Status::Dropped) {
+                DELIVERY_LOG_DEBUG("event", .topic(contentTopic).field("transferId", QString::fromLatin1(chunk.transferId.toHex()))
+                    .message("chunk dropped"));
+                return;
+            }
+            if (chunk.status == PayloadChunker::Status::Complete) {
+                reassembled = encodeBase64(chunk.payload);
+                encodedPayload = utf8View(reassembled);
+            }
+        }
+
+        if (receivedStore.enabled()) {
+            // Stored as received: base64 wire payload, topic and hash unescaped
+            receivedStore.append(utf8View(contentTopic.toUtf8()), utf8View(messageHash.toUtf8()), encodedPayload,
+                messageTimestamp.toLongLong());
+        }
+
+        // Only payloads carrying the compression header are decoded here
+        std::optional<QByteArray> decompressed;
+        if (PayloadCompressor::isCompressedBase64(encodedPayload)) {
+            decompressed = payloadCompressor.decompress(contentTopic, decodeBase64(encodedPayload));
+            if (!decompressed) {
+                DELIVERY_LOG_WARNING("event", .topic(contentTopic).field("messageHash", messageHash)
+                    .message("compressed payload could not be decompressed, emitted as received"));
+            }
+        }
+
+        if (payloadFormat != PayloadFormat::Bytes) {
             QVariantList eventData;
-            eventData << jsonObj["requestId"].toString();
-            eventData << jsonObj["messageHash"].toString();
-            eventData << timestamp;
-            plugin->emitEvent("messagePropagated", eventData);
-            
-        } else if (eventType == "message_received") {
-            // MessageReceivedEvent: messageHash, message (WakuMessage)
-            QJsonObject msgObj = jsonObj["message"].toObject();
+            eventData << messageHash << contentTopic;
+            if (decompressed) {
+                eventData << QString::fromLatin1(encodeBase64(*decompressed));
+            } else if (!reassembled.isEmpty()) {
+                eventData << QString::fromLatin1(reassembled);
+            } else {
+                eventData << eventField(event, event.payload, DeliveryEventView::Payload);
+            }
+            eventData << messageTimestamp;
+            emitEvent(DeliveryEventType::MessageReceived, eventData, enqueuedAt, routes);
+        }
+        if (payloadFormat != PayloadFormat::Base64) {
             QVariantList eventData;
-            eventData << jsonObj["messageHash"].toString();
-            eventData << msgObj["contentTopic"].toString();
-            eventData << msgObj["payload"].toString();
-            eventData << QString::number(msgObj["timestamp"].toDouble(), 'f', 0);
-            plugin->emitEvent("messageReceived", eventData);
+            eventData << messageHash << contentTopic;
+            eventData << (decompressed ? *decompressed : decodeBase64(encodedPayload));
+            eventData << messageTimestamp;
+            emitEvent(DeliveryEventType::MessageReceivedBytes, eventData, enqueuedAt, routes);
+        }
 
-        } else if (eventType == "connection_status_change") {
-            QVariantList eventData;
-            eventData << jsonObj["connectionStatus"].toString();
-            eventData << timestamp;
-            plugin->emitEvent("connectionStateChanged", eventData);
-            
-        } else {
-            qWarning() << "DeliveryModulePlugin::event_callback: Unknown event type:" << eventType;
+    } else if (eventType == "connection_status_change") {
+        QVariantList eventData;
+        const QString status = eventField(event, event.connectionStatus, DeliveryEventView::ConnectionStatus);
+        eventData << status;
+        eventData << timestamp();
+        nodeInfoCache.invalidate(NodeInfoCache::Lifetime::Volatile);
+        if (!status.isEmpty() && status != "Disconnected") {
+            std::lock_guard<std::mutex> lock(connectionMutex);
+            if (!firstPeerAt) {
+                firstPeerAt = enqueuedAt;
+                peerConnected.notify_all();
+            }
         }
+        emitEvent(DeliveryEventType::ConnectionStateChanged, eventData, enqueuedAt);
+
+    } else {
+        DELIVERY_LOG_WARNING("event", .field("eventType", eventField(event, event.eventType, DeliveryEventView::EventType))
+            .message("unknown event type"));
     }
 }
 
 void DeliveryModulePlugin::initLogos(LogosAPI* logosAPIInstance) {
+    std::lock_guard<std::mutex> lock(logosApiMutex);
+    // Cached clients belong to the API instance being replaced
+    deliveryClient = nullptr;
+    routedClients.clear();
     if (logosAPI) {
         delete logosAPI;
     }
     logosAPI = logosAPIInstance;
+    if (logosAPI) {
+        deliveryClient = resolveClient(name());
+    }
 }
 
 bool DeliveryModulePlugin::createNode(const QString &cfg)
 {
-    qDebug() << "DeliveryModulePlugin::createNode called with cfg:" << cfg;
-    
-    // Convert QString to UTF-8 byte array
-    QByteArray cfgUtf8 = cfg.toUtf8();
-    
+    return createNode(cfg, nullptr);
+}
+
+bool DeliveryModulePlugin::createNode(const QString &cfg, std::chrono::steady_clock::duration* parseTime)
+{
+    DELIVERY_LOG_DEBUG("createNode", .field("configBytes", static_cast<qint64>(cfg.size()))
+        .field("configKeys", configKeys(cfg)));
+
+    std::lock_guard<std::mutex> lock(createNodeMutex);
+
+    // Module options are consumed here; liblogosdelivery only sees its own config.
+    // Nothing is applied until every new context exists, so a failed call leaves
+    // the current node as it was.
+    const auto parseStartedAt = std::chrono::steady_clock::now();
+    DeliveryModuleOptions options;
+    const QByteArray cfgUtf8 = DeliveryModuleOptions::extract(cfg, options);
+    if (parseTime) {
+        *parseTime = std::chrono::steady_clock::now() - parseStartedAt;
+    }
+
+    auto destroyContexts = [](const std::vector<void*>& contexts) {
+        for (void* ctx : contexts) {
+            logosdelivery_destroy(ctx, nullptr, nullptr);
+        }
+    };
+    std::vector<void*> contexts;
+    contexts.reserve(options.nodePoolSize);
+    for (size_t i = 0; i < options.nodePoolSize; ++i) {
+        void* ctx = createContext(NodePool::memberConfig(cfgUtf8, i));
+        if (!ctx) {
+            // All or nothing: a partial pool would route some topics nowhere
+            destroyContexts(contexts);
+            DELIVERY_LOG_WARNING("createNode", .field("member", static_cast<qint64>(i))
+                .field("poolSize", static_cast<qint64>(options.nodePoolSize)).message("failed to create pool member"));
+            return false;
+        }
+        contexts.push_back(ctx);
+    }
+    // Success case - every context is valid, callbacks won't be called
+    DELIVERY_LOG_INFO("createNode", .field("poolSize", static_cast<qint64>(contexts.size())).message("contexts created"));
+
+    auto opened = openStorage(options);
+    if (opened.isErr()) {
+        DELIVERY_LOG_WARNING("createNode", .message(opened.error()));
+        destroyContexts(contexts);
+        // Back to the journal and store of the current node
+        auto restored = openStorage(moduleOptions);
+        if (restored.isErr()) {
+            DELIVERY_LOG_WARNING("createNode", .message("cannot restore storage: " + restored.error()));
+        }
+        return false;
+    }
+
+    // Waits for the calls still using the previous pool and keeps new ones out until the swap is done
+    std::unique_lock<std::shared_mutex> contextLock(contextMutex);
+    // The previous pool would keep running and firing events into this plugin
+    releasePool();
+
+    moduleOptions = std::move(options);
+    sendAdmission.setLimits({moduleOptions.maxInflightSends, moduleOptions.maxInflightSendsPerTopic});
+    receivedDedup.configure(std::chrono::milliseconds(moduleOptions.dedupWindowMs), moduleOptions.dedupCapacity);
+    payloadCompressor.configure({moduleOptions.compressTopics, static_cast<int>(moduleOptions.compressionLevel),
+        static_cast<qsizetype>(moduleOptions.compressMinBytes)});
+    payloadChunker.configure({moduleOptions.reassemblyMaxBytes, std::chrono::milliseconds(moduleOptions.reassemblyTimeoutMs)});
+    // Cached answers belong to the previous context
+    nodeInfoCache.invalidateAll();
+    nodeInfoCache.setTtl(NodeInfoCache::Lifetime::Volatile, std::chrono::milliseconds(moduleOptions.nodeInfoCacheTtlMs));
+    nodeInfoCache.setTtl(NodeInfoCache::Lifetime::Static, std::chrono::milliseconds(moduleOptions.staticNodeInfoCacheTtlMs));
+    for (size_t op = 0; op < callTimeoutsMs.size(); ++op) {
+        callTimeoutsMs[op].store(moduleOptions.callTimeoutMs[op], std::memory_order_relaxed);
+    }
+    receivedPayloadFormat.store(moduleOptions.receivedPayloadFormat, std::memory_order_relaxed);
+    maxTransferBytes.store(moduleOptions.maxTransferBytes, std::memory_order_relaxed);
+    maxMessageBytes.store(moduleOptions.maxMessageBytes, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> connectionLock(connectionMutex);
+        firstPeerAt.reset();
+    }
+
+    const auto routing = moduleOptions.nodePoolRouting == DeliveryModuleOptions::NodePoolRouting::Autoshard
+        ? NodePool::Routing::Autoshard : NodePool::Routing::ContentTopic;
+    deliveryCtx = contexts.front();
+    nodePool.assign(contexts, routing);
+
+    // Set up event callbacks; events of all members merge in the dispatcher's ring
+    startEventDispatcher();
+    for (void* ctx : contexts) {
+        logosdelivery_set_event_callback(ctx, event_callback, this);
+    }
+    return true;
+}
+
+QExpected<void> DeliveryModulePlugin::openStorage(const DeliveryModuleOptions& options)
+{
+    if (!options.journalDir.isEmpty()) {
+        OutboundJournal::Config journalConfig;
+        journalConfig.directory = options.journalDir;
+        journalConfig.segmentBytes = options.journalSegmentBytes;
+        switch (options.journalSync) {
+        case DeliveryModuleOptions::JournalSync::None: journalConfig.sync = OutboundJournal::SyncPolicy::None; break;
+        case DeliveryModuleOptions::JournalSync::Interval: journalConfig.sync = OutboundJournal::SyncPolicy::Interval; break;
+        case DeliveryModuleOptions::JournalSync::Always: journalConfig.sync = OutboundJournal::SyncPolicy::Always; break;
+        }
+        journalConfig.syncInterval = std::chrono::milliseconds(options.journalSyncIntervalMs);
+        auto opened = outboundJournal.open(journalConfig);
+        if (opened.isErr()) {
+            return opened;
+        }
+        DELIVERY_LOG_INFO("createNode", .field("journalDir", options.journalDir)
+            .field("journalPending", static_cast<qint64>(outboundJournal.stats().pending)));
+    } else {
+        outboundJournal.close();
+    }
+    if (!options.receivedStorePath.isEmpty()) {
+        ReceivedStore::Config storeConfig;
+        storeConfig.path = options.receivedStorePath;
+        storeConfig.capacityBytes = options.receivedStoreBytes;
+        storeConfig.maxAge = std::chrono::milliseconds(options.receivedStoreMaxAgeMs);
+        auto opened = receivedStore.open(storeConfig);
+        if (opened.isErr()) {
+            return opened;
+        }
+        DELIVERY_LOG_INFO("createNode", .field("receivedStorePath", options.receivedStorePath)
+            .field("storedMessages", static_cast<qint64>(receivedStore.stats().messages)));
+    } else {
+        receivedStore.close();
+    }
+    return QExpected<void>::ok();
+}
+
+void* DeliveryModulePlugin::createContext(const QByteArray& cfgUtf8)
+{
     // Create semaphore and callback context for synchronous operation
     // Callback is only called in failure case
     struct CallbackContext {
@@ -147,20 +574,16 @@ bool DeliveryModulePlugin::createNode(const QString &cfg)
     std::binary_semaphore sem(0);
     CallbackContext ctx{&sem, false};
     
-    // Lambda callback that will be called only on failure (when deliveryCtx is nullptr)
+    // Lambda callback that will be called only on failure (when the context is nullptr)
     auto callback = +[](int callerRet, const char* msg, size_t len, void* userData) {
-        qDebug() << "DeliveryModulePlugin::createNode callback called with ret:" << callerRet;
-        
         CallbackContext* ctx = static_cast<CallbackContext*>(userData);
         if (!ctx) {
-            qWarning() << "DeliveryModulePlugin::createNode callback: Invalid userData";
+            DELIVERY_LOG_WARNING("createNode", .message("invalid userData"));
             return;
         }
-        
-        if (msg && len > 0) {
-            QString message = QString::fromUtf8(msg, len);
-            qDebug() << "DeliveryModulePlugin::createNode callback message:" << message;
-        }
+
+        DELIVERY_LOG_WARNING("createNode", .field("ret", static_cast<qint64>(callerRet))
+            .message(msg && len > 0 ? QString::fromUtf8(msg, static_cast<qsizetype>(len)) : QString()));
         
         ctx->callbackInvoked = true;
         
@@ -169,117 +592,654 @@ bool DeliveryModulePlugin::createNode(const QString &cfg)
     };
     
     // Call logosdelivery_create_node with the configuration
-    // Important: Keep deliveryCtx assignment from the call
-    deliveryCtx = logosdelivery_create_node(cfgUtf8.constData(), callback, &ctx);
+    const auto startedAt = std::chrono::steady_clock::now();
+    void* deliveryContext = logosdelivery_create_node(cfgUtf8.constData(), callback, &ctx);
     
-    // If deliveryCtx is nullptr, callback will be invoked with error details
-    if (!deliveryCtx) {
-        qDebug() << "DeliveryModulePlugin: Waiting for createNode error callback...";
-        
+    // If the context is nullptr, callback will be invoked with error details
+    if (!deliveryContext) {
         // Wait for callback to complete with timeout
-        if (!sem.try_acquire_for(CALLBACK_TIMEOUT)) {
-            qWarning() << "DeliveryModulePlugin: Timeout waiting for createNode callback";
-            return false;
+        if (!sem.try_acquire_for(callTimeout(FfiOperation::CreateNode))) {
+            DeliveryMetrics::instance().recordCall(FfiOperation::CreateNode, CallOutcome::Timeout, {});
+            DELIVERY_LOG_WARNING("createNode", .message("no callback before the call timeout"));
+            return nullptr;
         }
         
-        qWarning() << "DeliveryModulePlugin: Failed to create Messaging context";
-        return false;
+        DeliveryMetrics::instance().recordCall(FfiOperation::CreateNode, CallOutcome::Failed,
+            std::chrono::steady_clock::now() - startedAt);
+        DELIVERY_LOG_WARNING("createNode", .message("failed to create the delivery context"));
+        return nullptr;
     }
-    
-    // Success case - deliveryCtx is valid, callback won't be called
-    qDebug() << "DeliveryModulePlugin: Messaging context created successfully";
-    
-    // Set up event callback
-    logosdelivery_set_event_callback(deliveryCtx, event_callback, this);
-    return true;
+    DeliveryMetrics::instance().recordCall(FfiOperation::CreateNode, CallOutcome::Ok,
+        std::chrono::steady_clock::now() - startedAt);
+    return deliveryContext;
+}
+
+void* DeliveryModulePlugin::topicContext(const QString& contentTopic) const
+{
+    if (nodePool.size() <= 1) {
+        return deliveryCtx;
+    }
+    return nodePool.forTopic(utf8View(contentTopic.toUtf8()));
+}
+
+QExpected<void> DeliveryModulePlugin::updatePool(FfiOperation operation)
+{
+    const auto ffiCall = operation == FfiOperation::Start ? logosdelivery_start_node : logosdelivery_stop_node;
+    auto invokeFor = [ffiCall](void* ctx) {
+        return bindApiCall(ffiCall, ctx);
+    };
+    std::vector<decltype(invokeFor(nullptr))> invokes;
+    for (void* ctx : nodePool.contexts()) {
+        invokes.push_back(invokeFor(ctx));
+    }
+
+    const auto outcomes = callApiRetVoidMany(operation, callTimeout(operation), invokes);
+    for (size_t i = 0; i < outcomes.size(); ++i) {
+        if (outcomes[i].isErr()) {
+            return outcomes.size() == 1 ? outcomes[i]
+                : QExpected<void>::err(QStringLiteral("pool member %1: %2").arg(i).arg(outcomes[i].error()));
+        }
+    }
+    return QExpected<void>::ok();
+}
+
+void DeliveryModulePlugin::releasePool()
+{
+    if (nodePool.empty()) {
+        return;
+    }
+    // Stopping a pool that never started fails harmlessly
+    auto stopped = updatePool(FfiOperation::Stop);
+    if (stopped.isErr()) {
+        DELIVERY_LOG_DEBUG("createNode", .message("previous pool: " + stopped.error()));
+    }
+    const std::vector<void*> previous = nodePool.release();
+    deliveryCtx = nullptr;
+    for (void* ctx : previous) {
+        logosdelivery_destroy(ctx, nullptr, nullptr);
+    }
+    DELIVERY_LOG_INFO("createNode", .field("destroyedContexts", static_cast<qint64>(previous.size())));
 }
 
 bool DeliveryModulePlugin::start()
 {
-    qDebug() << "DeliveryModulePlugin::start called";
-    
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
     if (!deliveryCtx) {
-        qWarning() << "DeliveryModulePlugin: Cannot start Messaging - context not initialized. Call createNode first.";
+        DELIVERY_LOG_WARNING("start", .message("context not initialized, call createNode first"));
         return false;
     }
     
-    auto outcome = callApiRetVoid(
-        "start",
-        CALLBACK_TIMEOUT,
-        bindApiCall(logosdelivery_start_node, deliveryCtx));
+    auto outcome = updatePool(FfiOperation::Start);
 
     if (outcome.isErr()) {
-        qWarning() << "DeliveryModulePlugin: Start failed:" << outcome.error();
+        DELIVERY_LOG_WARNING("start", .message(outcome.error()));
         return false;
     }
 
-    qDebug() << "DeliveryModulePlugin: Messaging start completed with success: true";
+    DELIVERY_LOG_INFO("start", .message("node started"));
+    replayJournal();
     return true;
 }
 
 bool DeliveryModulePlugin::stop()
 {
-    qDebug() << "DeliveryModulePlugin::stop called";
-    
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
     if (!deliveryCtx) {
-        qWarning() << "DeliveryModulePlugin: Cannot stop Messaging - context not initialized.";
+        DELIVERY_LOG_WARNING("stop", .message("context not initialized"));
         return false;
     }
     
-    auto outcome = callApiRetVoid(
-        "stop",
-        CALLBACK_TIMEOUT,
-        bindApiCall(logosdelivery_stop_node, deliveryCtx));
+    auto outcome = updatePool(FfiOperation::Stop);
 
     if (outcome.isErr()) {
-        qWarning() << "DeliveryModulePlugin: Stop failed:" << outcome.error();
+        DELIVERY_LOG_WARNING("stop", .message(outcome.error()));
         return false;
     }
 
-    qDebug() << "DeliveryModulePlugin: Messaging stop completed with success: true";
+    // Accepted sends without an outcome go out again on the next start
+    outboundJournal.markStopped();
+    DELIVERY_LOG_INFO("stop", .message("node stopped"));
     return true;
 }
+
+QExpected<QString> DeliveryModulePlugin::bootstrap(const QString &cfg, const QStringList &contentTopics)
+{
+    using Clock = std::chrono::steady_clock;
+    auto toMs = [](Clock::duration elapsed) {
+        return std::chrono::duration<double, std::milli>(elapsed).count();
+    };
+
+    const auto startedAt = Clock::now();
+    Clock::duration parseTime{};
+    if (!createNode(cfg, &parseTime)) {
+        DELIVERY_LOG_WARNING("bootstrap", .message("createNode failed"));
+        return QExpected<QString>::err("bootstrap: createNode failed");
+    }
+    const auto createdAt = Clock::now();
+
+    // Another createNode may replace the pool as soon as ours is released
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
+    auto started = updatePool(FfiOperation::Start);
+    if (started.isErr()) {
+        DELIVERY_LOG_WARNING("bootstrap", .message(started.error()));
+        return QExpected<QString>::err(QStringLiteral("bootstrap: start failed: %1").arg(started.error()));
+    }
+    const auto nodeStartedAt = Clock::now();
+    replayJournal();
+
+    // Subscriptions go out while the node is still looking for peers
+    QJsonArray failedTopics;
+    if (!contentTopics.isEmpty()) {
+        auto subscriptions = updateSubscriptions(FfiOperation::Subscribe, contentTopics);
+        const QVariantList results = subscriptions.isOk() ? subscriptions.value() : QVariantList();
+        for (qsizetype i = 0; i < contentTopics.size(); ++i) {
+            if (i >= results.size() || QExpected<void>::fromVariant(results.at(i)).isErr()) {
+                failedTopics.append(contentTopics.at(i));
+            }
+        }
+    }
+    const auto subscribedAt = Clock::now();
+    const size_t poolSize = nodePool.size();
+    contextLock.unlock();
+
+    // Peers usually show up within the start budget; a slow network is not an error
+    std::optional<Clock::time_point> connectedAt;
+    {
+        std::unique_lock<std::mutex> lock(connectionMutex);
+        peerConnected.wait_until(lock, nodeStartedAt + callTimeout(FfiOperation::Start),
+            [this]() { return firstPeerAt.has_value(); });
+        connectedAt = firstPeerAt;
+    }
+
+    QJsonObject phases;
+    phases["configParse"] = toMs(parseTime);
+    phases["contextCreate"] = toMs(createdAt - startedAt - parseTime);
+    phases["nodeStart"] = toMs(nodeStartedAt - createdAt);
+    phases["subscriptions"] = toMs(subscribedAt - nodeStartedAt);
+    // Measured from the start request, as peers cannot connect before
+    phases["firstPeerConnected"] = connectedAt ? QJsonValue(toMs(std::max(*connectedAt, createdAt) - createdAt))
+                                               : QJsonValue(QJsonValue::Null);
+
+    QJsonObject report;
+    report["phasesMs"] = phases;
+    report["totalMs"] = toMs(Clock::now() - startedAt);
+    report["poolSize"] = static_cast<qint64>(poolSize);
+    report["peerConnected"] = connectedAt.has_value();
+    report["subscribed"] = static_cast<qint64>(contentTopics.size() - failedTopics.size());
+    report["failedTopics"] = failedTopics;
+    const QString reportJson = QString::fromUtf8(QJsonDocument(report).toJson(QJsonDocument::Compact));
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        lastBootstrap = report;
+    }
+
+    DELIVERY_LOG_INFO("bootstrap", .field("topics", static_cast<qint64>(contentTopics.size()))
+        .field("failedTopics", static_cast<qint64>(failedTopics.size()))
+        .field("peerConnected", static_cast<qint64>(connectedAt.has_value()))
+        .latency(Clock::now() - startedAt));
+    return QExpected<QString>::ok(reportJson);
+}
+void DeliveryModulePlugin::appendSendEnvelope(QByteArray& out, const QString& contentTopic, const QByteArray& payload, bool ephemeral)
+{
+    // Construct JSON message according to logosdelivery_send API
+    // The payload should be base64-encoded as per the API spec
+    out.append("{\"contentTopic\":");
+    appendJsonString(out, contentTopic.toUtf8());
+    out.append(",\"payload\":\"");
+    appendBase64(out, utf8View(payload));
+    out.append(ephemeral ? "\",\"ephemeral\":true}" : "\",\"ephemeral\":false}");
+}
+
+QString DeliveryModulePlugin::admitSend(const QString& contentTopic, std::optional<uint64_t>& admissionKey)
+{
+    admissionKey.reset();
+    if (!sendAdmission.enabled()) {
+        return {};
+    }
+    const uint64_t key = SendAdmission::topicKey(utf8View(contentTopic.toUtf8()));
+    const SendAdmission::Decision decision = sendAdmission.tryAcquire(key);
+    if (!decision.admitted) {
+        return QStringLiteral("busy: retry after %1 ms (%2 sends in flight for %3, limit %4)")
+            .arg(decision.retryAfter.count())
+            .arg(decision.inflight)
+            .arg(decision.scope == SendAdmission::Scope::Topic ? "topic" : "node")
+            .arg(decision.limit);
+    }
+    admissionKey = key;
+    return {};
+}
+
+std::optional<uint64_t> DeliveryModulePlugin::journalSend(const QString& contentTopic, const QByteArray& payload, bool ephemeral)
+{
+    if (!outboundJournal.enabled()) {
+        return std::nullopt;
+    }
+    const std::optional<uint64_t> entry = outboundJournal.append(utf8View(contentTopic.toUtf8()), utf8View(payload), ephemeral);
+    if (!entry) {
+        DELIVERY_LOG_WARNING("journal", .topic(contentTopic).field("payloadBytes", static_cast<qint64>(payload.size()))
+            .message("message not journaled"));
+    }
+    return entry;
+}
+
+void DeliveryModulePlugin::settleJournal(const std::optional<uint64_t>& journalEntry, const QExpected<QString>& outcome)
+{
+    if (!journalEntry) {
+        return;
+    }
+    // The caller learns about a failed send call, so there is nothing to replay
+    if (outcome.isOk()) {
+        outboundJournal.bind(*journalEntry, utf8View(outcome.value().toUtf8()));
+    } else {
+        outboundJournal.retire(*journalEntry);
+    }
+}
+
+void DeliveryModulePlugin::replayJournal()
+{
+    const std::vector<OutboundJournal::Replay> replays = outboundJournal.pendingReplay();
+    if (replays.empty()) {
+        return;
+    }
+
+    QByteArray envelopes;
+    std::vector<qsizetype> offsets;
+    offsets.reserve(replays.size());
+    for (const OutboundJournal::Replay& replay : replays) {
+        offsets.push_back(envelopes.size());
+        appendSendEnvelope(envelopes, QString::fromUtf8(replay.contentTopic), replay.payload, replay.ephemeral);
+        envelopes.append('\0');
+    }
+
+    auto invokeFor = [](void* ctx, const char* messageJson) {
+        return bindApiCall(logosdelivery_send, ctx, messageJson);
+    };
+    std::vector<decltype(invokeFor(nullptr, nullptr))> invokes;
+    invokes.reserve(replays.size());
+    for (size_t i = 0; i < replays.size(); ++i) {
+        invokes.push_back(invokeFor(topicContext(QString::fromUtf8(replays[i].contentTopic)), envelopes.constData() + offsets[i]));
+    }
+
+    const auto startedAt = std::chrono::steady_clock::now();
+    const auto outcomes = callApiRetValueMany(FfiOperation::Send, callTimeout(FfiOperation::Send), invokes);
+    qint64 failed = 0;
+    for (size_t i = 0; i < replays.size(); ++i) {
+        // A replay that fails stays journaled for the next start
+        if (outcomes[i].isErr()) {
+            outboundJournal.deferReplay(replays[i].id);
+            ++failed;
+            continue;
+        }
+        outboundJournal.bind(replays[i].id, utf8View(outcomes[i].value().toUtf8()));
+        trackSend(outcomes[i].value(), startedAt, std::nullopt);
+    }
+
+    DELIVERY_LOG_INFO("replay", .field("messages", static_cast<qint64>(replays.size())).field("failed", failed)
+        .latency(std::chrono::steady_clock::now() - startedAt));
+}
+
+void DeliveryModulePlugin::trackSend(const QString& requestId, std::chrono::steady_clock::time_point startedAt,
+    const std::optional<uint64_t>& admissionKey)
+{
+    if (!inflightTracker.submit(utf8View(requestId.toUtf8()), startedAt, admissionKey)) {
+        releaseSend(admissionKey);
+    }
+}
+
+void DeliveryModulePlugin::releaseSend(const std::optional<uint64_t>& admissionKey)
+{
+    if (admissionKey) {
+        sendAdmission.release(*admissionKey, std::chrono::steady_clock::duration::zero());
+    }
+}
+
+std::chrono::milliseconds DeliveryModulePlugin::callTimeout(FfiOperation operation) const
+{
+    const uint32_t configured = callTimeoutsMs[static_cast<size_t>(operation)].load(std::memory_order_relaxed);
+    return configured > 0 ? std::chrono::milliseconds(configured) : std::chrono::milliseconds(CALLBACK_TIMEOUT);
+}
+
 QExpected<QString> DeliveryModulePlugin::send(const QString &contentTopic, const QString &payload)
 {
-    qDebug() << "DeliveryModulePlugin::send called with contentTopic:" << contentTopic;
-    qDebug() << "DeliveryModulePlugin::send payload:" << payload;
-    
+    return sendPayload(contentTopic, payload.toUtf8(), callTimeout(FfiOperation::Send));
+}
+
+QExpected<QString> DeliveryModulePlugin::sendBytes(const QString &contentTopic, const QByteArray &payload)
+{
+    return sendPayload(contentTopic, payload, callTimeout(FfiOperation::Send));
+}
+
+QExpected<QString> DeliveryModulePlugin::sendWithDeadline(const QString &contentTopic, const QString &payload,
+    int timeoutMs, const QString &cancelToken)
+{
+    const std::chrono::milliseconds timeout = timeoutMs > 0
+        ? std::chrono::milliseconds(timeoutMs)
+        : callTimeout(FfiOperation::Send);
+    if (cancelToken.isEmpty()) {
+        return sendPayload(contentTopic, payload.toUtf8(), timeout);
+    }
+
+    auto cancellation = std::make_shared<CancellationToken>();
+    {
+        std::lock_guard<std::mutex> lock(cancellationMutex);
+        if (cancellationTokens.contains(cancelToken)) {
+            return QExpected<QString>::err("cancel token already in use: " + cancelToken);
+        }
+        cancellationTokens.insert(cancelToken, cancellation);
+    }
+
+    QExpected<QString> outcome = sendPayload(contentTopic, payload.toUtf8(), timeout, cancellation.get());
+
+    std::lock_guard<std::mutex> lock(cancellationMutex);
+    cancellationTokens.remove(cancelToken);
+    return outcome;
+}
+
+bool DeliveryModulePlugin::cancelCall(const QString &cancelToken)
+{
+    std::shared_ptr<CancellationToken> cancellation;
+    {
+        std::lock_guard<std::mutex> lock(cancellationMutex);
+        cancellation = cancellationTokens.value(cancelToken);
+    }
+    const bool cancelled = cancellation && cancellation->cancel();
+    DELIVERY_LOG_DEBUG("cancelCall", .field("token", cancelToken).field("cancelled", static_cast<qint64>(cancelled)));
+    return cancelled;
+}
+
+QExpected<QString> DeliveryModulePlugin::sendPayload(const QString &contentTopic, const QByteArray &payload,
+    std::chrono::milliseconds timeout, CancellationToken* cancellation)
+{
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
     if (!deliveryCtx) {
-        qWarning() << "DeliveryModulePlugin: Cannot send message - context not initialized. Call createNode first.";
+        DELIVERY_LOG_WARNING("send", .topic(contentTopic).message("context not initialized, call createNode first"));
         return QExpected<QString>::err("Context not initialized");
     }
+
+    std::optional<uint64_t> admissionKey;
+    const QString busy = admitSend(contentTopic, admissionKey);
+    if (!busy.isEmpty()) {
+        DELIVERY_LOG_DEBUG("send", .topic(contentTopic).message(busy));
+        return QExpected<QString>::err(busy);
+    }
     
-    // Construct JSON message according to logosdelivery_send API
-    // The payload should be base64-encoded as per the API spec
-    QJsonObject messageObj;
-    messageObj["contentTopic"] = contentTopic;
-    messageObj["payload"] = QString::fromUtf8(payload.toUtf8().toBase64());
-    messageObj["ephemeral"] = false;
-    
-    QJsonDocument doc(messageObj);
-    QByteArray messageJson = doc.toJson(QJsonDocument::Compact);
+    const auto startedAt = std::chrono::steady_clock::now();
+    // The journal keeps the wire form so a replay sends the same bytes
+    const QByteArray wirePayload = payloadCompressor.compress(contentTopic, payload);
+    const qsizetype chunkBytes = chunkDataBytes(contentTopic);
+    if (chunkBytes > 0 && wirePayload.size() > chunkBytes + PayloadChunker::kHeaderBytes) {
+        const uint32_t transferLimit = maxTransferBytes.load(std::memory_order_relaxed);
+        if (wirePayload.size() > static_cast<qsizetype>(transferLimit)) {
+            releaseSend(admissionKey);
+            const QString error = QStringLiteral("payload of %1 bytes exceeds maxTransferBytes (%2)")
+                .arg(wirePayload.size()).arg(transferLimit);
+            DELIVERY_LOG_WARNING("send", .topic(contentTopic).message(error));
+            return QExpected<QString>::err(error);
+        }
+        return sendChunked(contentTopic, wirePayload, timeout, admissionKey, startedAt, cancellation);
+    }
+    const std::optional<uint64_t> journalEntry = journalSend(contentTopic, wirePayload, false);
+    QByteArray messageJson;
+    appendSendEnvelope(messageJson, contentTopic, wirePayload, false);
     
     auto outcome = callApiRetValue<QString>(
-        "send",
-        CALLBACK_TIMEOUT,
-        bindApiCall(logosdelivery_send, deliveryCtx, messageJson.constData()));
+        FfiOperation::Send,
+        timeout,
+        bindApiCall(logosdelivery_send, topicContext(contentTopic), messageJson.constData()),
+        cancellation);
+    settleJournal(journalEntry, outcome);
 
     if (outcome.isErr()) {
-        qWarning() << "DeliveryModulePlugin: Send failed for topic:" << contentTopic << ", reason:" << outcome.error();
+        releaseSend(admissionKey);
+        DELIVERY_LOG_WARNING("send", .topic(contentTopic).latency(std::chrono::steady_clock::now() - startedAt)
+            .message(outcome.error()));
         return QExpected<QString>::err(outcome.error());
     }
 
     const QString responseMessage = outcome.value();
-    qDebug() << "DeliveryModulePlugin: Send initiated for topic:" << contentTopic << ", with success: true";
+    trackSend(responseMessage, startedAt, admissionKey);
+    DELIVERY_LOG_DEBUG("send", .topic(contentTopic).requestId(responseMessage)
+        .field("payloadBytes", static_cast<qint64>(payload.size()))
+        .latency(std::chrono::steady_clock::now() - startedAt));
     return QExpected<QString>::ok(responseMessage);
 }
 
+qsizetype DeliveryModulePlugin::chunkDataBytes(const QString& contentTopic) const
+{
+    if (maxTransferBytes.load(std::memory_order_relaxed) == 0) {
+        return 0;
+    }
+    // What is left of one message once the envelope and the chunk header are accounted for
+    const qsizetype dataBytes = static_cast<qsizetype>(maxMessageBytes.load(std::memory_order_relaxed)) - PayloadChunker::kEnvelopeReserveBytes
+        - PayloadChunker::kHeaderBytes - contentTopic.toUtf8().size();
+    return std::max<qsizetype>(dataBytes, 0);
+}
+
+QExpected<QString> DeliveryModulePlugin::sendChunked(const QString& contentTopic, const QByteArray& wirePayload,
+    std::chrono::milliseconds timeout, const std::optional<uint64_t>& admissionKey,
+    std::chrono::steady_clock::time_point startedAt, CancellationToken* cancellation)
+{
+    const std::vector<QByteArray> chunks = payloadChunker.split(wirePayload, chunkDataBytes(contentTopic));
+    if (chunks.empty()) {
+        releaseSend(admissionKey);
+        const QString error = QStringLiteral("payload of %1 bytes needs more than %2 chunks")
+            .arg(wirePayload.size()).arg(PayloadChunker::kMaxChunks);
+        DELIVERY_LOG_WARNING("send", .topic(contentTopic).message(error));
+        return QExpected<QString>::err(error);
+    }
+
+    // Every chunk is a message of its own, journaled and tracked like any other
+    QByteArray envelopes;
+    std::vector<qsizetype> offsets;
+    std::vector<std::optional<uint64_t>> journalEntries;
+    offsets.reserve(chunks.size());
+    journalEntries.reserve(chunks.size());
+    for (const QByteArray& chunk : chunks) {
+        offsets.push_back(envelopes.size());
+        journalEntries.push_back(journalSend(contentTopic, chunk, false));
+        appendSendEnvelope(envelopes, contentTopic, chunk, false);
+        envelopes.append('\0');
+    }
+
+    void* ctx = topicContext(contentTopic);
+    auto invokeFor = [ctx](const char* messageJson) {
+        return bindApiCall(logosdelivery_send, ctx, messageJson);
+    };
+    std::vector<decltype(invokeFor(nullptr))> invokes;
+    invokes.reserve(chunks.size());
+    for (qsizetype offset : offsets) {
+        invokes.push_back(invokeFor(envelopes.constData() + offset));
+    }
+    const auto outcomes = callApiRetValueMany(FfiOperation::Send, timeout, invokes, cancellation);
+
+    QString firstError;
+    for (size_t i = 0; i < outcomes.size(); ++i) {
+        settleJournal(journalEntries[i], outcomes[i]);
+        if (outcomes[i].isErr() && firstError.isEmpty()) {
+            firstError = QStringLiteral("chunk %1 of %2: %3").arg(i + 1).arg(chunks.size()).arg(outcomes[i].error());
+        }
+    }
+    // The admission slot follows the last chunk; the others are tracked without one
+    for (size_t i = 0; i + 1 < outcomes.size(); ++i) {
+        if (outcomes[i].isOk()) {
+            trackSend(outcomes[i].value(), startedAt, std::nullopt);
+        }
+    }
+    if (!firstError.isEmpty()) {
+        if (outcomes.back().isOk()) {
+            trackSend(outcomes.back().value(), startedAt, std::nullopt);
+        }
+        releaseSend(admissionKey);
+        DELIVERY_LOG_WARNING("send", .topic(contentTopic).field("chunks", static_cast<qint64>(chunks.size()))
+            .latency(std::chrono::steady_clock::now() - startedAt).message(firstError));
+        return QExpected<QString>::err(firstError);
+    }
+
+    const QString requestId = outcomes.back().value();
+    trackSend(requestId, startedAt, admissionKey);
+    DELIVERY_LOG_DEBUG("send", .topic(contentTopic).requestId(requestId)
+        .field("payloadBytes", static_cast<qint64>(wirePayload.size()))
+        .field("chunks", static_cast<qint64>(chunks.size()))
+        .latency(std::chrono::steady_clock::now() - startedAt));
+    return QExpected<QString>::ok(requestId);
+}
+
+QExpected<QString> DeliveryModulePlugin::sendAsync(const QString &contentTopic, const QString &payload)
+{
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
+    if (!deliveryCtx) {
+        DELIVERY_LOG_WARNING("sendAsync", .topic(contentTopic).message("context not initialized, call createNode first"));
+        return QExpected<QString>::err("Context not initialized");
+    }
+
+    std::optional<uint64_t> admissionKey;
+    const QString busy = admitSend(contentTopic, admissionKey);
+    if (!busy.isEmpty()) {
+        DELIVERY_LOG_DEBUG("sendAsync", .topic(contentTopic).message(busy));
+        return QExpected<QString>::err(busy);
+    }
+
+    const QString handle = QStringLiteral("local-%1").arg(nextSendHandle.fetch_add(1, std::memory_order_relaxed));
+    const QByteArray wirePayload = payloadCompressor.compress(contentTopic, payload.toUtf8());
+    const qsizetype chunkBytes = chunkDataBytes(contentTopic);
+    if (chunkBytes > 0 && wirePayload.size() > chunkBytes + PayloadChunker::kHeaderBytes) {
+        releaseSend(admissionKey);
+        DELIVERY_LOG_WARNING("sendAsync", .topic(contentTopic).message("payload needs chunking"));
+        return QExpected<QString>::err(QStringLiteral("payload of %1 bytes exceeds maxMessageSize; use send for chunked transfers")
+            .arg(wirePayload.size()));
+    }
+    const std::optional<uint64_t> journalEntry = journalSend(contentTopic, wirePayload, false);
+    QByteArray messageJson;
+    appendSendEnvelope(messageJson, contentTopic, wirePayload, false);
+    const char* messageData = messageJson.constData();
+    const auto startedAt = std::chrono::steady_clock::now();
+
+    // The completion keeps the envelope alive until liblogosdelivery reports back
+    auto outcome = callApiAsync(
+        FfiOperation::Send,
+        callTimeout(FfiOperation::Send),
+        bindApiCall(logosdelivery_send, topicContext(contentTopic), messageData),
+        [this, handle, startedAt, admissionKey, journalEntry, messageJson = std::move(messageJson)](const QExpected<QString>& result) {
+            settleJournal(journalEntry, result);
+            if (result.isOk()) {
+                trackSend(result.value(), startedAt, admissionKey);
+            } else {
+                releaseSend(admissionKey);
+            }
+            QueuedEvent event;
+            event.receivedAtMs = QDateTime::currentMSecsSinceEpoch();
+            event.enqueuedAt = std::chrono::steady_clock::now();
+            event.type = result.isErr() ? DeliveryEventType::SendRejected : DeliveryEventType::SendAccepted;
+            event.data << handle << (result.isErr() ? result.error() : result.value());
+            if (!enqueueEvent(std::move(event))) {
+                DELIVERY_LOG_DEBUG("sendAsync", .field("handle", handle).message("acknowledgement dropped"));
+            }
+        },
+        asyncCalls);
+
+    if (outcome.isErr()) {
+        // The completion never runs when the call could not be initiated
+        releaseSend(admissionKey);
+        settleJournal(journalEntry, QExpected<QString>::err(outcome.error()));
+        DELIVERY_LOG_WARNING("sendAsync", .topic(contentTopic).message(outcome.error()));
+        return QExpected<QString>::err(outcome.error());
+    }
+
+    return QExpected<QString>::ok(handle);
+}
+
+QExpected<QVariantList> DeliveryModulePlugin::sendBatch(const QVariantList &messages)
+{
+    DELIVERY_LOG_DEBUG("sendBatch", .field("messages", static_cast<qint64>(messages.size())));
+
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
+    if (!deliveryCtx) {
+        DELIVERY_LOG_WARNING("sendBatch", .message("context not initialized, call createNode first"));
+        return QExpected<QVariantList>::err("Context not initialized");
+    }
+
+    // Serialize every envelope into one NUL-separated buffer; offsets are turned
+    // into pointers only once the buffer has stopped growing.
+    QByteArray envelopes;
+    envelopes.reserve(messages.size() * 256);
+    std::vector<qsizetype> offsets;
+    std::vector<QString> rejections(messages.size());
+    std::vector<std::optional<uint64_t>> admissionKeys(messages.size());
+    std::vector<void*> contexts(messages.size(), nullptr);
+    std::vector<std::optional<uint64_t>> journalEntries(messages.size());
+    offsets.reserve(messages.size());
+
+    for (qsizetype i = 0; i < messages.size(); ++i) {
+        const QVariantMap message = messages.at(i).toMap();
+        const QString contentTopic = message.value("contentTopic").toString();
+        if (contentTopic.isEmpty()) {
+            rejections[i] = "missing contentTopic";
+            offsets.push_back(-1);
+            continue;
+        }
+        rejections[i] = admitSend(contentTopic, admissionKeys[i]);
+        if (!rejections[i].isEmpty()) {
+            offsets.push_back(-1);
+            continue;
+        }
+        const QByteArray payload = payloadCompressor.compress(contentTopic, message.value("payload").toString().toUtf8());
+        const qsizetype chunkBytes = chunkDataBytes(contentTopic);
+        if (chunkBytes > 0 && payload.size() > chunkBytes + PayloadChunker::kHeaderBytes) {
+            releaseSend(admissionKeys[i]);
+            rejections[i] = QStringLiteral("payload of %1 bytes exceeds maxMessageSize; use send for chunked transfers")
+                .arg(payload.size());
+            offsets.push_back(-1);
+            continue;
+        }
+        offsets.push_back(envelopes.size());
+        contexts[i] = topicContext(contentTopic);
+        const bool ephemeral = message.value("ephemeral", false).toBool();
+        journalEntries[i] = journalSend(contentTopic, payload, ephemeral);
+        appendSendEnvelope(envelopes, contentTopic, payload, ephemeral);
+        envelopes.append('\0');
+    }
+
+    auto invokeFor = [](void* ctx, const char* messageJson) {
+        return bindApiCall(logosdelivery_send, ctx, messageJson);
+    };
+    std::vector<decltype(invokeFor(nullptr, nullptr))> invokes;
+    invokes.reserve(messages.size());
+    for (qsizetype i = 0; i < messages.size(); ++i) {
+        if (offsets[i] >= 0) {
+            invokes.push_back(invokeFor(contexts[i], envelopes.constData() + offsets[i]));
+        }
+    }
+
+    const auto startedAt = std::chrono::steady_clock::now();
+    const auto outcomes = callApiRetValueMany(FfiOperation::Send, callTimeout(FfiOperation::Send), invokes);
+
+    QVariantList results;
+    results.reserve(messages.size());
+    size_t next = 0;
+    for (qsizetype i = 0; i < messages.size(); ++i) {
+        if (offsets[i] < 0) {
+            results << QExpected<QString>::err(rejections[i]).toVariant();
+            continue;
+        }
+        const QExpected<QString>& outcome = outcomes[next++];
+        settleJournal(journalEntries[i], outcome);
+        if (outcome.isErr()) {
+            releaseSend(admissionKeys[i]);
+            DELIVERY_LOG_WARNING("sendBatch", .field("index", static_cast<qint64>(i)).message(outcome.error()));
+        } else {
+            trackSend(outcome.value(), startedAt, admissionKeys[i]);
+        }
+        results << outcome.toVariant();
+    }
+
+    return QExpected<QVariantList>::ok(results);
+}
+
 bool DeliveryModulePlugin::subscribe(const QString &contentTopic)
 {
-    qDebug() << "DeliveryModulePlugin::subscribe called with contentTopic:" << contentTopic;
-    
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
     if (!deliveryCtx) {
-        qWarning() << "DeliveryModulePlugin: Cannot subscribe - context not initialized. Call createNode first.";
+        DELIVERY_LOG_WARNING("subscribe", .topic(contentTopic).message("context not initialized, call createNode first"));
         return false;
     }
     
@@ -287,25 +1247,24 @@ bool DeliveryModulePlugin::subscribe(const QString &contentTopic)
     QByteArray topicUtf8 = contentTopic.toUtf8();
     
     auto outcome = callApiRetVoid(
-        "subscribe",
-        CALLBACK_TIMEOUT,
-        bindApiCall(logosdelivery_subscribe, deliveryCtx, topicUtf8.constData()));
+        FfiOperation::Subscribe,
+        callTimeout(FfiOperation::Subscribe),
+        bindApiCall(logosdelivery_subscribe, topicContext(contentTopic), topicUtf8.constData()));
 
     if (outcome.isErr()) {
-        qWarning() << "DeliveryModulePlugin: Subscribe failed for topic:" << contentTopic << ", reason:" << outcome.error();
+        DELIVERY_LOG_WARNING("subscribe", .topic(contentTopic).message(outcome.error()));
         return false;
     }
 
-    qDebug() << "DeliveryModulePlugin: Subscribe completed for topic:" << contentTopic << " with success: true";
+    DELIVERY_LOG_DEBUG("subscribe", .topic(contentTopic));
     return true;
 }
 
 bool DeliveryModulePlugin::unsubscribe(const QString &contentTopic)
 {
-    qDebug() << "DeliveryModulePlugin::unsubscribe called with contentTopic:" << contentTopic;
-    
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
     if (!deliveryCtx) {
-        qWarning() << "DeliveryModulePlugin: Cannot unsubscribe - context not initialized.";
+        DELIVERY_LOG_WARNING("unsubscribe", .topic(contentTopic).message("context not initialized"));
         return false;
     }
     
@@ -313,53 +1272,174 @@ bool DeliveryModulePlugin::unsubscribe(const QString &contentTopic)
     QByteArray topicUtf8 = contentTopic.toUtf8();
     
     auto outcome = callApiRetVoid(
-        "unsubscribe",
-        CALLBACK_TIMEOUT,
-        bindApiCall(logosdelivery_unsubscribe, deliveryCtx, topicUtf8.constData()));
+        FfiOperation::Unsubscribe,
+        callTimeout(FfiOperation::Unsubscribe),
+        bindApiCall(logosdelivery_unsubscribe, topicContext(contentTopic), topicUtf8.constData()));
 
     if (outcome.isErr()) {
-        qWarning() << "DeliveryModulePlugin: Unsubscribe failed for topic:" << contentTopic << ", reason:" << outcome.error();
+        DELIVERY_LOG_WARNING("unsubscribe", .topic(contentTopic).message(outcome.error()));
         return false;
     }
 
-    qDebug() << "DeliveryModulePlugin: Unsubscribe completed for topic:" << contentTopic << " with success: true";
+    DELIVERY_LOG_DEBUG("unsubscribe", .topic(contentTopic));
     return true;
 }
 
+bool DeliveryModulePlugin::addTopicRoute(const QString &contentTopic, const QString &clientName)
+{
+    if (contentTopic.isEmpty() || clientName.isEmpty()) {
+        DELIVERY_LOG_WARNING("addTopicRoute", .topic(contentTopic).field("client", clientName)
+            .message("content topic and client name are required"));
+        return false;
+    }
+    const bool added = topicRouter.add(utf8View(contentTopic.toUtf8()), clientName);
+    DELIVERY_LOG_DEBUG("addTopicRoute", .topic(contentTopic).field("client", clientName)
+        .field("added", static_cast<qint64>(added)));
+    return added;
+}
+
+bool DeliveryModulePlugin::removeTopicRoute(const QString &contentTopic, const QString &clientName)
+{
+    const bool removed = topicRouter.remove(utf8View(contentTopic.toUtf8()), clientName);
+    DELIVERY_LOG_DEBUG("removeTopicRoute", .topic(contentTopic).field("client", clientName)
+        .field("removed", static_cast<qint64>(removed)));
+    return removed;
+}
+
+QExpected<QVariantList> DeliveryModulePlugin::subscribeMany(const QStringList &contentTopics)
+{
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
+    return updateSubscriptions(FfiOperation::Subscribe, contentTopics);
+}
+
+QExpected<QVariantList> DeliveryModulePlugin::unsubscribeMany(const QStringList &contentTopics)
+{
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
+    return updateSubscriptions(FfiOperation::Unsubscribe, contentTopics);
+}
+
+QExpected<QVariantList> DeliveryModulePlugin::queryReceived(const QString &contentTopic, qint64 sinceNs, int limit)
+{
+    if (!receivedStore.enabled()) {
+        DELIVERY_LOG_WARNING("queryReceived", .topic(contentTopic).message("received store not configured"));
+        return QExpected<QVariantList>::err("Received store not configured, set receivedStorePath");
+    }
+
+    const auto startedAt = std::chrono::steady_clock::now();
+    const std::vector<ReceivedStore::Message> messages = receivedStore.query(
+        utf8View(contentTopic.toUtf8()), sinceNs, limit > 0 ? static_cast<size_t>(limit) : 0);
+
+    QVariantList results;
+    results.reserve(static_cast<qsizetype>(messages.size()));
+    for (const ReceivedStore::Message& message : messages) {
+        QVariantMap entry;
+        entry["messageHash"] = QString::fromUtf8(message.messageHash);
+        entry["contentTopic"] = QString::fromUtf8(message.contentTopic);
+        // The store keeps the wire form; expand it as messageReceived did
+        std::optional<QByteArray> decompressed;
+        if (PayloadCompressor::isCompressedBase64(utf8View(message.payload))) {
+            decompressed = payloadCompressor.decompress(QString::fromUtf8(message.contentTopic),
+                decodeBase64(utf8View(message.payload)));
+        }
+        entry["payload"] = QString::fromLatin1(decompressed ? encodeBase64(*decompressed) : message.payload);
+        entry["timestamp"] = QString::number(message.timestampNs);
+        results << entry;
+    }
+
+    DELIVERY_LOG_DEBUG("queryReceived", .topic(contentTopic).field("messages", static_cast<qint64>(results.size()))
+        .latency(std::chrono::steady_clock::now() - startedAt));
+    return QExpected<QVariantList>::ok(results);
+}
+
+QExpected<QVariantList> DeliveryModulePlugin::updateSubscriptions(FfiOperation operation, const QStringList &contentTopics)
+{
+    const char* operationName = operation == FfiOperation::Subscribe ? "subscribeMany" : "unsubscribeMany";
+
+    if (!deliveryCtx) {
+        DELIVERY_LOG_WARNING(operationName, .message("context not initialized, call createNode first"));
+        return QExpected<QVariantList>::err("Context not initialized");
+    }
+
+    // One NUL-separated buffer for all topics; pointers are taken once it stops growing
+    QByteArray topics;
+    std::vector<qsizetype> offsets;
+    offsets.reserve(contentTopics.size());
+    for (const QString& contentTopic : contentTopics) {
+        offsets.push_back(topics.size());
+        topics.append(contentTopic.toUtf8()).append('\0');
+    }
+
+    const auto ffiCall = operation == FfiOperation::Subscribe ? logosdelivery_subscribe : logosdelivery_unsubscribe;
+    auto invokeFor = [ffiCall](void* ctx, const char* contentTopic) {
+        return bindApiCall(ffiCall, ctx, contentTopic);
+    };
+    std::vector<decltype(invokeFor(nullptr, nullptr))> invokes;
+    invokes.reserve(offsets.size());
+    for (qsizetype i = 0; i < contentTopics.size(); ++i) {
+        invokes.push_back(invokeFor(topicContext(contentTopics.at(i)), topics.constData() + offsets[i]));
+    }
+
+    const auto startedAt = std::chrono::steady_clock::now();
+    const auto outcomes = callApiRetVoidMany(operation, callTimeout(operation), invokes);
+
+    QVariantList results;
+    results.reserve(contentTopics.size());
+    qint64 failed = 0;
+    for (qsizetype i = 0; i < contentTopics.size(); ++i) {
+        const QExpected<void>& outcome = outcomes[i];
+        if (outcome.isErr()) {
+            ++failed;
+            DELIVERY_LOG_WARNING(operationName, .topic(contentTopics.at(i)).message(outcome.error()));
+        }
+        results << outcome.toVariant();
+    }
+
+    DELIVERY_LOG_DEBUG(operationName, .field("topics", static_cast<qint64>(contentTopics.size()))
+        .field("failed", failed).latency(std::chrono::steady_clock::now() - startedAt));
+    return QExpected<QVariantList>::ok(results);
+}
+
 QString DeliveryModulePlugin::version() const {
     QString moduleVersion = "1.0.0";
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
     if (!deliveryCtx) {
-        qWarning() << "DeliveryModulePlugin: Cannot subscribe - context not initialized. Call createNode first.";
+        DELIVERY_LOG_WARNING("version", .message("context not initialized, call createNode first"));
         return moduleVersion + " (liblogosdelivery version unknown, context not initialized)";
     }
 
     auto attributeName = "Version";
-    auto liblogosDeliveryVersion = callApiRetValue<QString>(
-        "get_node_info",
-        CALLBACK_TIMEOUT,
-        bindApiCall(logosdelivery_get_node_info, deliveryCtx, attributeName));
+    auto liblogosDeliveryVersion = nodeInfoCache.get(nodeInfoCacheKey(attributeName),
+        NodeInfoCache::Lifetime::Static, [this, attributeName]() {
+            return callApiRetValue<QString>(
+                FfiOperation::GetNodeInfo,
+                callTimeout(FfiOperation::GetNodeInfo),
+                bindApiCall(logosdelivery_get_node_info, deliveryCtx, attributeName));
+        });
 
     if (liblogosDeliveryVersion.isErr()) {
-        qWarning() << "DeliveryModulePlugin: Get node info failed getting version, reason:" <<
-            liblogosDeliveryVersion.error();
+        DELIVERY_LOG_WARNING("getNodeInfo", .field("nodeInfoId", QString::fromLatin1(attributeName))
+            .message(liblogosDeliveryVersion.error()));
         return moduleVersion + " (liblogosdelivery version unknown)";
     }
 
     const QString version = liblogosDeliveryVersion.value();
-    qDebug() << "DeliveryModulePlugin: Get node info completed for attribute:" <<
-        attributeName << ", with success: " << version;
+    DELIVERY_LOG_DEBUG("getNodeInfo", .field("nodeInfoId", QString::fromLatin1(attributeName)).field("value", version));
 
     return moduleVersion + " (liblogosdelivery version: " + version + ")";
 }
 
 QString DeliveryModulePlugin::getAvailableNodeInfoIDs() {
-    auto outcome = callApiRetValue<QString>(
-        "get_available_node_info_ids",
-        CALLBACK_TIMEOUT,
-        bindApiCall(logosdelivery_get_available_node_info_ids, deliveryCtx));
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
+    auto outcome = nodeInfoCache.get(QStringLiteral("available_node_info_ids"),
+        NodeInfoCache::Lifetime::Static, [this]() {
+            return callApiRetValue<QString>(
+                FfiOperation::GetAvailableNodeInfoIds,
+                callTimeout(FfiOperation::GetAvailableNodeInfoIds),
+                bindApiCall(logosdelivery_get_available_node_info_ids, deliveryCtx));
+        });
 
     if (outcome.isErr()) {
-        qWarning() << "DeliveryModulePlugin: Get available node info IDs failed, reason:" << outcome.error();
+        DELIVERY_LOG_WARNING("getAvailableNodeInfoIDs", .message(outcome.error()));
         return QString();
     }
 
@@ -367,28 +1447,187 @@ QString DeliveryModulePlugin::getAvailableNodeInfoIDs() {
 }
 
 QString DeliveryModulePlugin::getNodeInfo(const QString &nodeInfoId) {
-    auto outcome = callApiRetValue<QString>(
-        "get_node_info",
-        CALLBACK_TIMEOUT,
-        bindApiCall(logosdelivery_get_node_info, deliveryCtx, nodeInfoId.toUtf8().constData()));
+    if (nodeInfoId == QLatin1String("ModuleEventQueue")) {
+        const auto stats = eventQueue.stats();
+        QJsonObject info;
+        info["capacity"] = static_cast<qint64>(stats.capacity);
+        info["depth"] = static_cast<qint64>(stats.depth);
+        info["highWater"] = static_cast<qint64>(stats.highWater);
+        info["enqueued"] = static_cast<qint64>(stats.pushed);
+        info["dispatched"] = static_cast<qint64>(stats.popped);
+        info["dropped"] = static_cast<qint64>(stats.dropped);
+        info["clientLookups"] = static_cast<qint64>(clientLookups.load(std::memory_order_relaxed));
+        return QString::fromUtf8(QJsonDocument(info).toJson(QJsonDocument::Compact));
+    }
+    if (nodeInfoId == QLatin1String("ModuleMetrics")) {
+        return getMetrics();
+    }
+
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
+    const auto lifetime = nodeInfoId == QLatin1String("Version")
+        ? NodeInfoCache::Lifetime::Static
+        : NodeInfoCache::Lifetime::Volatile;
+    auto outcome = nodeInfoCache.get(nodeInfoCacheKey(nodeInfoId), lifetime, [this, &nodeInfoId]() {
+        const QByteArray nodeInfoIdUtf8 = nodeInfoId.toUtf8();
+        return callApiRetValue<QString>(
+            FfiOperation::GetNodeInfo,
+            callTimeout(FfiOperation::GetNodeInfo),
+            bindApiCall(logosdelivery_get_node_info, deliveryCtx, nodeInfoIdUtf8.constData()));
+    });
 
     if (outcome.isErr()) {
-        qWarning() << "DeliveryModulePlugin: Get node info failed for ID:" << nodeInfoId <<
-            ", reason:" << outcome.error();
+        DELIVERY_LOG_WARNING("getNodeInfo", .field("nodeInfoId", nodeInfoId).message(outcome.error()));
         return QString();
     }
 
     return outcome.value();
 }
 
+QString DeliveryModulePlugin::getMetrics() {
+    QJsonObject metrics = DeliveryMetrics::instance().toJson();
+
+    const auto stats = inflightTracker.stats(std::chrono::steady_clock::now());
+    QJsonObject inflight;
+    inflight["capacity"] = static_cast<qint64>(stats.capacity);
+    inflight["tracked"] = static_cast<qint64>(stats.tracked);
+    inflight["stuck"] = static_cast<qint64>(stats.stuck);
+    inflight["submitted"] = static_cast<qint64>(stats.submitted);
+    inflight["propagated"] = static_cast<qint64>(stats.propagated);
+    inflight["sent"] = static_cast<qint64>(stats.sent);
+    inflight["failed"] = static_cast<qint64>(stats.failed);
+    inflight["expired"] = static_cast<qint64>(stats.expired);
+    inflight["orphaned"] = static_cast<qint64>(stats.orphaned);
+    inflight["overflowed"] = static_cast<qint64>(stats.overflowed);
+    metrics["inflight"] = inflight;
+
+    const SendAdmission::Stats admissionStats = sendAdmission.stats();
+    QJsonObject admission;
+    admission["perNodeLimit"] = static_cast<qint64>(admissionStats.limits.perNode);
+    admission["perTopicLimit"] = static_cast<qint64>(admissionStats.limits.perTopic);
+    admission["inflight"] = static_cast<qint64>(admissionStats.inflight);
+    admission["admitted"] = static_cast<qint64>(admissionStats.admitted);
+    admission["rejectedNode"] = static_cast<qint64>(admissionStats.rejectedNode);
+    admission["rejectedTopic"] = static_cast<qint64>(admissionStats.rejectedTopic);
+    metrics["admission"] = admission;
+
+    const TopicRouter::Stats routingStats = topicRouter.stats();
+    QJsonObject routing;
+    routing["topics"] = static_cast<qint64>(routingStats.topics);
+    routing["routes"] = static_cast<qint64>(routingStats.routes);
+    routing["routed"] = static_cast<qint64>(routingStats.routed);
+    routing["unrouted"] = static_cast<qint64>(routingStats.unrouted);
+    metrics["routing"] = routing;
+
+    const MessageDedup::Stats dedupStats = receivedDedup.stats();
+    QJsonObject dedup;
+    dedup["enabled"] = dedupStats.enabled;
+    dedup["windowMs"] = static_cast<qint64>(dedupStats.window.count());
+    dedup["capacity"] = static_cast<qint64>(dedupStats.capacity);
+    dedup["tracked"] = static_cast<qint64>(dedupStats.tracked);
+    dedup["unique"] = static_cast<qint64>(dedupStats.unique);
+    dedup["duplicates"] = static_cast<qint64>(dedupStats.duplicates);
+    dedup["falsePositives"] = static_cast<qint64>(dedupStats.falsePositives);
+    metrics["dedup"] = dedup;
+
+    const NodeInfoCache::Stats cacheStats = nodeInfoCache.stats();
+    QJsonObject cache;
+    cache["entries"] = static_cast<qint64>(cacheStats.entries);
+    cache["hits"] = static_cast<qint64>(cacheStats.hits);
+    cache["misses"] = static_cast<qint64>(cacheStats.misses);
+    cache["coalesced"] = static_cast<qint64>(cacheStats.coalesced);
+    cache["invalidations"] = static_cast<qint64>(cacheStats.invalidations);
+    metrics["nodeInfoCache"] = cache;
+
+    QJsonObject pool;
+    {
+        std::shared_lock<std::shared_mutex> contextLock(contextMutex);
+        pool["size"] = static_cast<qint64>(nodePool.size());
+        pool["routing"] = nodePool.routing() == NodePool::Routing::Autoshard ? "autoshard" : "contentTopic";
+    }
+    metrics["pool"] = pool;
+
+    const OutboundJournal::Stats journalStats = outboundJournal.stats();
+    QJsonObject journal;
+    journal["enabled"] = journalStats.enabled;
+    journal["segments"] = static_cast<qint64>(journalStats.segments);
+    journal["pending"] = static_cast<qint64>(journalStats.pending);
+    journal["appended"] = static_cast<qint64>(journalStats.appended);
+    journal["retired"] = static_cast<qint64>(journalStats.retired);
+    journal["recovered"] = static_cast<qint64>(journalStats.recovered);
+    journal["replayed"] = static_cast<qint64>(journalStats.replayed);
+    journal["rejected"] = static_cast<qint64>(journalStats.rejected);
+    journal["syncs"] = static_cast<qint64>(journalStats.syncs);
+    metrics["journal"] = journal;
+
+    const ReceivedStore::Stats storeStats = receivedStore.stats();
+    QJsonObject store;
+    store["enabled"] = storeStats.enabled;
+    store["capacityBytes"] = static_cast<qint64>(storeStats.capacityBytes);
+    store["usedBytes"] = static_cast<qint64>(storeStats.usedBytes);
+    store["messages"] = static_cast<qint64>(storeStats.messages);
+    store["topics"] = static_cast<qint64>(storeStats.topics);
+    store["stored"] = static_cast<qint64>(storeStats.stored);
+    store["evicted"] = static_cast<qint64>(storeStats.evicted);
+    store["rejected"] = static_cast<qint64>(storeStats.rejected);
+    store["queries"] = static_cast<qint64>(storeStats.queries);
+    metrics["receivedStore"] = store;
+
+    QJsonObject compression;
+    for (const auto& [contentTopic, topicStats] : payloadCompressor.stats()) {
+        QJsonObject topic;
+        topic["compressed"] = static_cast<qint64>(topicStats.compressed);
+        topic["skipped"] = static_cast<qint64>(topicStats.skipped);
+        topic["rawBytes"] = static_cast<qint64>(topicStats.rawBytes);
+        topic["wireBytes"] = static_cast<qint64>(topicStats.wireBytes);
+        topic["ratio"] = topicStats.wireBytes
+            ? static_cast<double>(topicStats.rawBytes) / static_cast<double>(topicStats.wireBytes) : 0.0;
+        topic["compressNs"] = static_cast<qint64>(topicStats.compressNs);
+        topic["decompressed"] = static_cast<qint64>(topicStats.decompressed);
+        topic["decompressFailed"] = static_cast<qint64>(topicStats.decompressFailed);
+        topic["receivedRawBytes"] = static_cast<qint64>(topicStats.receivedRawBytes);
+        topic["receivedWireBytes"] = static_cast<qint64>(topicStats.receivedWireBytes);
+        topic["decompressNs"] = static_cast<qint64>(topicStats.decompressNs);
+        compression[contentTopic] = topic;
+    }
+    metrics["compression"] = compression;
+
+    const PayloadChunker::Stats chunkStats = payloadChunker.stats();
+    QJsonObject chunking;
+    chunking["maxBytes"] = static_cast<qint64>(chunkStats.maxBytes);
+    chunking["partial"] = static_cast<qint64>(chunkStats.partial);
+    chunking["bufferedBytes"] = static_cast<qint64>(chunkStats.bufferedBytes);
+    chunking["transfersSent"] = static_cast<qint64>(chunkStats.transfersSent);
+    chunking["chunksSent"] = static_cast<qint64>(chunkStats.chunksSent);
+    chunking["chunksReceived"] = static_cast<qint64>(chunkStats.chunksReceived);
+    chunking["completed"] = static_cast<qint64>(chunkStats.completed);
+    chunking["expired"] = static_cast<qint64>(chunkStats.expired);
+    chunking["rejected"] = static_cast<qint64>(chunkStats.rejected);
+    chunking["duplicates"] = static_cast<qint64>(chunkStats.duplicates);
+    chunking["invalid"] = static_cast<qint64>(chunkStats.invalid);
+    metrics["chunking"] = chunking;
+
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        if (!lastBootstrap.isEmpty()) {
+            metrics["bootstrap"] = lastBootstrap;
+        }
+    }
+
+    return QString::fromUtf8(QJsonDocument(metrics).toJson(QJsonDocument::Compact));
+}
+
 QString DeliveryModulePlugin::getAvailableConfigs() {
-    auto outcome = callApiRetValue<QString>(
-        "get_available_configs",
-        CALLBACK_TIMEOUT,
-        bindApiCall(logosdelivery_get_available_configs, deliveryCtx));
+    std::shared_lock<std::shared_mutex> contextLock(contextMutex);
+    auto outcome = nodeInfoCache.get(QStringLiteral("available_configs"),
+        NodeInfoCache::Lifetime::Static, [this]() {
+            return callApiRetValue<QString>(
+                FfiOperation::GetAvailableConfigs,
+                callTimeout(FfiOperation::GetAvailableConfigs),
+                bindApiCall(logosdelivery_get_available_configs, deliveryCtx));
+        });
 
     if (outcome.isErr()) {
-        qWarning() << "DeliveryModulePlugin: Get available configs failed, reason:" << outcome.error();
+        DELIVERY_LOG_WARNING("getAvailableConfigs", .message(outcome.error()));
         return QString();
     }
 
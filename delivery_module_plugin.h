@@ -1,8 +1,37 @@
 #pragma once
 
 #include <QtCore/QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QStringList>
+#include <QtCore/QVariantList>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <semaphore>
+#include <shared_mutex>
+#include <thread>
+#include "async_call_registry.h"
+#include "cancellation_token.h"
+#include "delivery_metrics.h"
 #include "delivery_module_interface.h"
+#include "event_ring.h"
+#include "inflight_tracker.h"
+#include "message_dedup.h"
+#include "module_options.h"
+#include "node_info_cache.h"
+#include "node_pool.h"
+#include "outbound_journal.h"
+#include "payload_chunker.h"
+#include "payload_compressor.h"
+#include "received_store.h"
+#include "send_admission.h"
+#include "topic_router.h"
 #include "logos_api.h"
 #include "logos_api_client.h"
 
@@ -17,9 +46,16 @@
  * - call @ref start before message operations
  * - use @ref subscribe / @ref send / @ref unsubscribe as needed
  * - call @ref stop before shutdown
- * Notice all of these calls are synchronous.
+ * Notice all of these calls are synchronous, except @ref sendAsync.
  * 
  * Asynchronous events are emitted off thread as Logos Plugin events.
+ * The liblogosdelivery event callback only copies the raw event into a bounded
+ * lock-free ring; a dedicated dispatcher thread decodes and emits it, so a slow
+ * host never stalls the node's own event loop. Queue depth, high-water mark and
+ * drop counts are reported by @ref getNodeInfo with id `ModuleEventQueue`.
+ * Latency histograms and outcome counters for every FFI operation and emitted
+ * event type are available through @ref getMetrics.
+ *
  * Emitted plugin event contracts (name + `QVariantList data` indices):
  * - `messageSent` (see `send` method)
  *   - `data[0]` (`QString`): request id
@@ -37,8 +73,28 @@
  * - `messageReceived` (emitted when a message arrives on a subscribed topic)
  *   - `data[0]` (`QString`): message hash
  *   - `data[1]` (`QString`): content topic
- *   - `data[2]` (`QString`): payload (base64-encoded)
+ *   - `data[2]` (`QString`): payload (base64-encoded, decompressed if it was sent compressed)
  *   - `data[3]` (`QString`): timestamp (nanoseconds since epoch)
+ * - `sendAccepted` (see `sendAsync` method)
+ *   - `data[0]` (`QString`): local send handle returned by `sendAsync`
+ *   - `data[1]` (`QString`): request id
+ *   - `data[2]` (`QString`): local timestamp (ISO-8601)
+ * - `sendRejected` (see `sendAsync` method)
+ *   - `data[0]` (`QString`): local send handle returned by `sendAsync`
+ *   - `data[1]` (`QString`): error message
+ *   - `data[2]` (`QString`): local timestamp (ISO-8601)
+ * - `messageReceivedBytes` (opt-in through `receivedPayloadFormat`, see @ref createNode)
+ *   - `data[0]` (`QString`): message hash
+ *   - `data[1]` (`QString`): content topic
+ *   - `data[2]` (`QByteArray`): payload, already base64-decoded
+ *   - `data[3]` (`QString`): timestamp (nanoseconds since epoch)
+ * - `transferProgress` (a chunk of a larger payload arrived, see `send` method)
+ *   - `data[0]` (`QString`): transfer id (hex)
+ *   - `data[1]` (`QString`): content topic
+ *   - `data[2]` (`qint64`): chunks received so far
+ *   - `data[3]` (`qint64`): chunks in the transfer
+ *   - `data[4]` (`qint64`): payload bytes received so far
+ *   - `data[5]` (`qint64`): payload size
  * - `connectionStateChanged`
  *   - `data[0]` (`QString`): connection status
  *   - `data[1]` (`QString`): local timestamp (ISO-8601)
@@ -68,8 +124,8 @@ public:
     /**
      * @brief Destroys the plugin and releases owned resources.
      *
-     * If present, the owned `LogosAPI` instance is deleted and the underlying
-     * liblogosdelivery context is destroyed.
+     * If present, the owned `LogosAPI` instance is deleted and every
+     * liblogosdelivery context of the node pool is destroyed.
      */
     virtual ~DeliveryModulePlugin();
 
@@ -132,7 +188,41 @@ public:
      * }
      * @endcode
      *
+     * ## Module options
+     * Settings for the plugin itself go under a `deliveryModule` object, which is
+     * removed before the configuration reaches liblogosdelivery
+     * (see @ref DeliveryModuleOptions):
+     * | Key                     | Type   | Default    | Description                                              |
+     * |-------------------------|--------|------------|----------------------------------------------------------|
+     * | `receivedPayloadFormat` | string | `"base64"` | `"base64"` (`messageReceived`), `"bytes"` (`messageReceivedBytes`) or `"both"` |
+     * | `maxInflightSends`      | number | `0`        | Sends awaiting their outcome before new ones are refused as busy; `0` is unlimited |
+     * | `maxInflightSendsPerTopic` | number | `0`     | Same cap per content topic; `0` is unlimited             |
+     * | `dedupWindowMs`         | number | `0`        | Drop received messages whose hash was seen within this window; `0` is off |
+     * | `dedupCapacity`         | number | `8192`     | Received message hashes remembered for deduplication     |
+     * | `nodeInfoCacheTtlMs`    | number | `1000`     | Cache lifetime of node info that may change at runtime; `0` is off |
+     * | `staticNodeInfoCacheTtlMs` | number | `3600000` | Cache lifetime of the version, node info ids and configs; `0` is off |
+     * | `callTimeoutsMs`        | object | `{}`       | Callback timeout per operation (`send`, `start`, `subscribe`, ..., `default`); unset means 30 s |
+     * | `nodePoolSize`          | number | `1`        | liblogosdelivery contexts to run (1-64); members add their index to `portsShift` and drop `nodekey` |
+     * | `nodePoolRouting`       | string | `"contentTopic"` | `"contentTopic"` hashes the whole topic, `"autoshard"` only `/{application}/{version}` |
+     * | `journalDir`            | string | `""`       | Directory of the outbound journal; empty disables it     |
+     * | `journalSegmentBytes`   | number | `8388608`  | Size of each journal segment file (at least 64 KiB)      |
+     * | `journalSync`           | string | `"interval"` | `"none"`, `"interval"` or `"always"`: when journal writes reach the disk |
+     * | `journalSyncIntervalMs` | number | `100`      | Flush period of the `"interval"` policy                  |
+     * | `receivedStorePath`     | string | `""`       | File of the received message store behind @ref queryReceived; empty disables it |
+     * | `receivedStoreBytes`    | number | `67108864` | Ring size of the received message store (at least 1 MiB) |
+     * | `receivedStoreMaxAgeMs` | number | `0`        | Drop stored messages older than this; `0` keeps them until the ring is full |
+     * | `compressTopics`        | array  | `[]`       | Content topics whose sent payloads are compressed; a trailing `*` matches a prefix |
+     * | `compressionLevel`      | number | `1`        | zlib level of payload compression (1-9)                  |
+     * | `compressMinBytes`      | number | `256`      | Payloads smaller than this are sent uncompressed         |
+     * | `maxTransferBytes`      | number | `0`        | Largest payload @ref send splits into chunks when it exceeds `maxMessageSize`; `0` is off |
+     * | `reassemblyMaxBytes`    | number | `67108864` | Memory for incoming chunked transfers not yet complete; `0` disables reassembly |
+     * | `reassemblyTimeoutMs`   | number | `60000`    | Discard a partial transfer after this long without a chunk (at least 1 s) |
+     *
      * @param cfg UTF-16 Qt string containing a UTF-8 serializable JSON payload.
+     * A previous node is only replaced once every new context has been
+     * created and the journal and received store are open; on failure it keeps
+     * running with its module options.
+     *
      * @return `true` if context creation succeeds and callback returns `RET_OK`,
      *         otherwise `false`.
      */
@@ -140,6 +230,9 @@ public:
 
     /**
      * @brief Starts the delivery node.
+     *
+     * Messages left in the outbound journal by an earlier run or an earlier
+     * @ref stop are sent again once the node is up.
      * @return `true` on success; `false` when no context exists or start fails.
      */
     Q_INVOKABLE bool start() override;
@@ -150,6 +243,26 @@ public:
      */
     Q_INVOKABLE bool stop() override;
 
+    /**
+     * @brief Creates and starts the node and subscribes to @p contentTopics in one call.
+     *
+     * Equivalent to @ref createNode, @ref start and @ref subscribeMany, except
+     * that the subscriptions are issued while the node is still connecting to
+     * peers. The call then waits for the first peer, at most the `start` call
+     * timeout counted from the start request.
+     *
+     * The report is compact JSON: `phasesMs` holds `configParse`,
+     * `contextCreate`, `nodeStart`, `subscriptions` and `firstPeerConnected`
+     * (since the start request; `null` when no peer connected in time), followed
+     * by `totalMs`, `poolSize`, `peerConnected`, `subscribed` and the
+     * `failedTopics`. The latest report is also returned by @ref getMetrics.
+     *
+     * @param cfg Same configuration as @ref createNode.
+     * @param contentTopics Topics to subscribe to; failures are reported, not fatal.
+     * @return The report, or an error when the node could not be created or started.
+     */
+    Q_INVOKABLE QExpected<QString> bootstrap(const QString &cfg, const QStringList &contentTopics) override;
+
     /**
      * @brief Sends a message over the active node.
      *
@@ -165,12 +278,117 @@ public:
      * - `messageSent` emitted after the sent message is validated by the network.
      * 
      * @param contentTopic Destination content topic.
+     * When `maxInflightSends` or `maxInflightSendsPerTopic` is configured (see
+     * @ref createNode) and the cap is reached, the send fails fast with an error
+     * of the form `busy: retry after <n> ms (<m> sends in flight for node|topic, limit <l>)`;
+     * a slot frees up when an earlier send gets `messageSent` or `messageError`.
+     *
+     * On topics listed in `compressTopics` the payload is compressed before
+     * it is base64-encoded; receivers running this module decompress it
+     * before `messageReceived`.
+     *
+     * With `maxTransferBytes` set, a payload too large for one message
+     * (`maxMessageSize`) is split into chunks sent as separate messages that
+     * share a transfer id. The returned request id is the last chunk's; each
+     * chunk gets its own `messageSent` / `messageError`. Receivers running
+     * this module emit `transferProgress` per chunk and one `messageReceived`
+     * once all chunks arrived. If any chunk is refused the call fails, and
+     * receivers discard the chunks that went out after `reassemblyTimeoutMs`.
+     * A chunked send waits for all chunks until the send timeout and cannot be
+     * cancelled through @ref cancelCall.
+     *
+     * @param contentTopic Destination content topic.
      * @param payload Raw message bytes represented as QString; converted to UTF-8
      *                bytes and base64-encoded before crossing the FFI boundary.
      * @return Success with request id, or error details.
      */
     Q_INVOKABLE QExpected<QString> send(const QString &contentTopic, const QString &payload) override;
 
+    /**
+     * @brief Sends a message without waiting for liblogosdelivery to acknowledge it.
+     *
+     * Builds the same envelope as @ref send, initiates `logosdelivery_send` and
+     * returns immediately with a locally generated handle. The FFI acknowledgement
+     * is reported later through events carrying that handle:
+     * - `sendAccepted` with the request id, after which the regular
+     *   `messagePropagated` / `messageSent` / `messageError` events follow.
+     * - `sendRejected` with the error message if liblogosdelivery refused the send.
+     *
+     * A single caller thread can keep any number of sends in flight this way.
+     * A send that is not acknowledged within the `send` call timeout is
+     * reported as `sendRejected` with a timeout error.
+     * Payloads that would need chunking (see @ref send) are refused.
+     *
+     * @param contentTopic Destination content topic.
+     * @param payload Raw message bytes represented as QString, encoded as in @ref send.
+     * @return Success with the local send handle, or error details if the send
+     *         could not be initiated (including the `busy` error of @ref send).
+     */
+    Q_INVOKABLE QExpected<QString> sendAsync(const QString &contentTopic, const QString &payload) override;
+
+    /**
+     * @brief @ref send with its own time budget and an optional cancellation token.
+     *
+     * The call returns a `send callback timeout` error once @p timeoutMs has
+     * passed without an acknowledgement, or `send cancelled` once another
+     * caller passes @p cancelToken to @ref cancelCall. Either way the pending
+     * callback slot is reclaimed immediately; for a chunked payload the budget
+     * and the token cover all chunks together. liblogosdelivery is not
+     * interrupted, so the message may still go out; its events then carry a
+     * request id this caller never saw.
+     *
+     * @param contentTopic Destination content topic.
+     * @param payload Raw message bytes represented as QString, encoded as in @ref send.
+     * @param timeoutMs Time budget in milliseconds; `0` or less uses the configured `send` timeout.
+     * @param cancelToken Caller-chosen id for @ref cancelCall; empty if the call cannot be cancelled.
+     * @return Success with request id, or error details.
+     */
+    Q_INVOKABLE QExpected<QString> sendWithDeadline(const QString &contentTopic, const QString &payload,
+        int timeoutMs, const QString &cancelToken) override;
+
+    /**
+     * @brief Releases the caller blocked in @ref sendWithDeadline with @p cancelToken.
+     * @return `true` if a waiting call was cancelled; `false` if no call uses
+     *         the token or it was already cancelled.
+     */
+    Q_INVOKABLE bool cancelCall(const QString &cancelToken) override;
+
+    /**
+     * @brief Sends a binary message over the active node.
+     *
+     * Same contract and events as @ref send, but the payload bytes are
+     * base64-encoded as-is, without a detour through QString/UTF-8.
+     *
+     * @param contentTopic Destination content topic.
+     * @param payload Raw message bytes (e.g. a serialized protobuf).
+     * @return Success with request id, or error details.
+     */
+    Q_INVOKABLE QExpected<QString> sendBytes(const QString &contentTopic, const QByteArray &payload) override;
+
+    /**
+     * @brief Sends many messages with a single wait for their FFI acknowledgements.
+     *
+     * Every envelope is serialized in one pass into a shared buffer, all
+     * `logosdelivery_send` calls are initiated back to back and the caller
+     * then waits once for all of their callbacks (bounded by the common
+     * callback timeout), amortizing the per-message overhead of @ref send.
+     *
+     * Each entry of @p messages is a `QVariantMap` with:
+     * - `contentTopic` (`QString`, required)
+     * - `payload` (`QString`, encoded as in @ref send)
+     * - `ephemeral` (`bool`, default `false`)
+     *
+     * Messages refused by the in-flight caps get the `busy` error of @ref send
+     * in their result slot, as do payloads that would need chunking; the rest
+     * of the batch is still sent.
+     *
+     * @param messages Batch of messages to send.
+     * @return On success a list with one serialized `QExpected<QString>` per
+     *         message, in input order, holding its request id or error; an
+     *         error if the batch could not be attempted at all.
+     */
+    Q_INVOKABLE QExpected<QVariantList> sendBatch(const QVariantList &messages) override;
+
     /**
      * @brief Subscribes to the supplied content topic.
      * @param contentTopic Topic identifier.
@@ -184,15 +402,148 @@ public:
      * @return `true` when unsubscribed successfully, otherwise `false`.
      */
     Q_INVOKABLE bool unsubscribe(const QString &contentTopic) override;
+
+    /**
+     * @brief Delivers messages received on @p contentTopic to the Logos API client @p clientName.
+     *
+     * Without routes every received message goes to the `delivery_module`
+     * client. Once a topic has routes, its `messageReceived` /
+     * `messageReceivedBytes` events go only to the routed clients, so each
+     * consumer gets just the topics it registered for. Routing does not
+     * subscribe; call @ref subscribe as well.
+     *
+     * @param contentTopic Topic identifier.
+     * @param clientName Name passed to `LogosAPI::getClient`.
+     * @return `true` if the route was added, `false` if it existed or an argument is empty.
+     */
+    Q_INVOKABLE bool addTopicRoute(const QString &contentTopic, const QString &clientName) override;
+
+    /**
+     * @brief Removes a route added by @ref addTopicRoute; a topic without routes
+     *        goes back to the `delivery_module` client.
+     * @return `true` if the route existed.
+     */
+    Q_INVOKABLE bool removeTopicRoute(const QString &contentTopic, const QString &clientName) override;
+
+    /**
+     * @brief Subscribes to many content topics with a single wait.
+     *
+     * All `logosdelivery_subscribe` calls are initiated back to back and the
+     * caller waits once for all of their callbacks (bounded by the common
+     * callback timeout), so subscribing to N topics costs one round-trip
+     * instead of N.
+     *
+     * @param contentTopics Topic identifiers.
+     * @return On success a list with one serialized `QExpected<void>` per
+     *         topic, in input order; an error if the context is not initialized.
+     */
+    Q_INVOKABLE QExpected<QVariantList> subscribeMany(const QStringList &contentTopics) override;
+
+    /**
+     * @brief Unsubscribes from many content topics with a single wait.
+     *
+     * Counterpart of @ref subscribeMany using `logosdelivery_unsubscribe`.
+     *
+     * @param contentTopics Topic identifiers.
+     * @return On success a list with one serialized `QExpected<void>` per
+     *         topic, in input order; an error if the context is not initialized.
+     */
+    Q_INVOKABLE QExpected<QVariantList> unsubscribeMany(const QStringList &contentTopics) override;
+
+    /**
+     * @brief Messages this node received on a content topic, from the local store.
+     *
+     * Served from the ring configured with `receivedStorePath` (see
+     * @ref createNode), which keeps every message emitted as `messageReceived`
+     * or `messageReceivedBytes`, across restarts, until its space or age limit
+     * is reached. No network request is made.
+     *
+     * @param contentTopic Content topic to read.
+     * @param sinceNs Oldest message timestamp to return, in nanoseconds since epoch.
+     * @param limit Most messages to return; `0` or less returns all of them.
+     * @return Maps with `messageHash`, `contentTopic`, `payload` (base64 and
+     *         decompressed, as in `messageReceived`) and `timestamp`, oldest first; an error when
+     *         the store is not configured.
+     */
+    Q_INVOKABLE QExpected<QVariantList> queryReceived(const QString &contentTopic, qint64 sinceNs, int limit) override;
     Q_INVOKABLE QString getAvailableNodeInfoIDs() override;
 
     /**
      * @brief Semantic version of this plugin implementation.
+     *
+     * Besides the ids reported by liblogosdelivery, the module answers
+     * `ModuleEventQueue` locally with a JSON object describing the event ring:
+     * `capacity`, `depth`, `highWater`, `enqueued`, `dispatched` and `dropped`,
+     * plus `clientLookups`, the number of Logos API client lookups so far.
+     * `ModuleMetrics` returns the same document as @ref getMetrics.
+     *
      * @param nodeInfoId Identifier for the requested node info item.
      * @return UTF-16 string containing UTF-8 serializable JSON data, or an empty string on error.
      */
     Q_INVOKABLE QString getNodeInfo(const QString &nodeInfoId) override;
 
+    /**
+     * @brief Module metrics as compact JSON, also available as node info `ModuleMetrics`.
+     *
+     * `operations` maps each FFI operation (`start`, `send`, `get_node_info`, ...)
+     * to its `calls`, `ok`, `failed`, `timeouts`, `notInitiated` and `cancelled` counts and a
+     * `latencyNs` summary (`count`, `mean`, `max`, `p50`, `p90`, `p99`, `p999`)
+     * of the time spent waiting for the FFI callback. `events` maps each emitted
+     * event name to `emitted`, `undelivered` (no Logos API client available)
+     * and a `latencyNs` summary from ingestion to emission. `delivery` holds
+     * `latencyNs` summaries from the `send` call to `propagated`, `sent` and
+     * `error`. These counters are process-wide and cumulative.
+     *
+     * `inflight` describes this node's in-flight table: `tracked` and `stuck`
+     * (pending for over 30 s) right now, plus cumulative `submitted`,
+     * `propagated`, `sent`, `failed`, `expired` (no terminal event within
+     * 5 min), `orphaned` (events for ids never returned by a send) and
+     * `overflowed` (ids not tracked because the table was full).
+     *
+     * `admission` reports the configured `perNodeLimit` and `perTopicLimit`
+     * (`0` when unlimited), the sends currently holding a slot (`inflight`)
+     * and cumulative `admitted`, `rejectedNode` and `rejectedTopic` counts.
+     *
+     * `routing` reports the routed `topics` and `routes` (topic/client pairs)
+     * and how many received messages were `routed` or `unrouted`.
+     *
+     * `nodeInfoCache` reports the cached `entries` and cumulative `hits`,
+     * `misses`, `coalesced` (misses served by a concurrent fetch) and
+     * `invalidations`.
+     *
+     * `dedup` reports whether deduplication is `enabled`, its `windowMs`,
+     * `capacity` and `tracked` hashes, and cumulative `unique`, `duplicates`
+     * (dropped) and `falsePositives` (filter hits delivered because the exact
+     * table could not confirm them).
+     *
+     * `pool` reports the number of contexts (`size`) and the topic `routing`
+     * in use (`contentTopic` or `autoshard`).
+     *
+     * `bootstrap` holds the report of the latest @ref bootstrap, if any.
+     *
+     * `journal` reports whether the outbound journal is `enabled`, its
+     * `segments` and `pending` messages, and cumulative `appended`, `retired`,
+     * `recovered` (found on open), `replayed`, `rejected` (too large to
+     * journal) and `syncs`.
+     *
+     * `receivedStore` reports whether the store is `enabled`, its
+     * `capacityBytes`, `usedBytes`, `messages` and `topics`, and cumulative
+     * `stored`, `evicted`, `rejected` (too large) and `queries`.
+     *
+     * `compression` maps each content topic that compressed or decompressed
+     * payloads (topics past the first 1024 share `*`) to its sent `compressed`
+     * and `skipped` messages, `rawBytes`, `wireBytes`, their `ratio` and
+     * `compressNs`, and its `decompressed` and `decompressFailed` payloads
+     * (received or read back by @ref queryReceived), `receivedRawBytes`,
+     * `receivedWireBytes` and `decompressNs`.
+     *
+     * `chunking` reports the reassembly budget `maxBytes`, the `partial`
+     * transfers and their `bufferedBytes`, and cumulative `transfersSent`,
+     * `chunksSent`, `chunksReceived`, `completed`, `expired`, `rejected`
+     * (over the budget), `duplicates` and `invalid` chunks.
+     */
+    Q_INVOKABLE QString getMetrics() override;
+
     /**
      * @brief Information about the available configuration parameters to be used in `createNode`.
      */
@@ -205,7 +556,9 @@ public:
     /**
      * @brief Injects/replaces the Logos API bridge used for event forwarding.
      *
-     * Ownership is transferred to this plugin instance.
+     * Ownership is transferred to this plugin instance. The `delivery_module`
+     * client used for every emitted event is resolved here, once, and dropped
+     * together with the instance it came from.
      *
      * @param logosAPIInstance Heap-allocated API object or `nullptr`.
      */
@@ -221,32 +574,378 @@ signals:
 
 private:
     /**
-     * @brief Opaque liblogosdelivery context pointer.
+     * @brief Drives the private hot paths from bench/delivery_module_bench.cpp.
+     */
+    friend struct DeliveryModuleBenchAccess;
+
+    /**
+     * @brief Keeps the contexts of @ref nodePool alive while they are in use.
+     *
+     * Every public call that reaches liblogosdelivery holds it shared from its
+     * context check to its last callback; @ref createNode holds it exclusively
+     * while it releases the previous pool and publishes the new one, and the
+     * destructor while it destroys the pool.
+     */
+    mutable std::shared_mutex contextMutex;
+
+    /**
+     * @brief Opaque liblogosdelivery context pointer; the primary of @ref nodePool.
+     * Guarded by @ref contextMutex.
      */
     void* deliveryCtx;
 
+    /**
+     * @brief Contexts created by @ref createNode; sends and subscriptions go to
+     * the member serving their content topic, node-wide queries to the primary.
+     * Guarded by @ref contextMutex.
+     */
+    NodePool nodePool;
+
+    /**
+     * @brief Creates one liblogosdelivery context from @p cfgUtf8.
+     * @return The context, or `nullptr` once the error callback has reported back.
+     */
+    void* createContext(const QByteArray& cfgUtf8);
+
+    /**
+     * @brief Context serving @p contentTopic; `nullptr` before @ref createNode.
+     */
+    void* topicContext(const QString& contentTopic) const;
+
+    /**
+     * @brief Outbound messages not yet reported sent; open when `journalDir` is configured.
+     */
+    OutboundJournal outboundJournal;
+
+    /**
+     * @brief History of received messages for @ref queryReceived; open when `receivedStorePath` is configured.
+     */
+    ReceivedStore receivedStore;
+
+    /**
+     * @brief Payload codec of the topics listed in `compressTopics`; decompresses any received payload.
+     */
+    PayloadCompressor payloadCompressor;
+
+    /**
+     * @brief Splits payloads above `maxMessageSize` and reassembles received chunks.
+     */
+    PayloadChunker payloadChunker;
+
+    /**
+     * @brief Payload bytes carried by each chunk on @p contentTopic; `0` when chunking is off.
+     */
+    qsizetype chunkDataBytes(const QString& contentTopic) const;
+
+    /**
+     * @brief @ref sendPayload for a payload that needs more than one message;
+     * @p cancellation abandons every chunk still waiting for its callback.
+     */
+    QExpected<QString> sendChunked(const QString& contentTopic, const QByteArray& wirePayload,
+        std::chrono::milliseconds timeout, const std::optional<uint64_t>& admissionKey,
+        std::chrono::steady_clock::time_point startedAt, CancellationToken* cancellation);
+
+    /**
+     * @brief Journals a message before it is sent; nothing when the journal is off.
+     */
+    std::optional<uint64_t> journalSend(const QString& contentTopic, const QByteArray& payload, bool ephemeral);
+
+    /**
+     * @brief Binds a journaled message to its request id, or retires it when the send call failed.
+     */
+    void settleJournal(const std::optional<uint64_t>& journalEntry, const QExpected<QString>& outcome);
+
+    /**
+     * @brief Sends the journal entries recovered on open or left without an
+     * outcome by the last @ref stop again after a start; the caller holds @ref contextMutex.
+     */
+    void replayJournal();
+
+    /**
+     * @brief Runs a start or stop call on every context of @ref nodePool; the caller holds @ref contextMutex.
+     */
+    QExpected<void> updatePool(FfiOperation operation);
+
+    /**
+     * @brief Stops and destroys every context of @ref nodePool, leaving it empty;
+     * the caller holds @ref contextMutex exclusively.
+     */
+    void releasePool();
+
+    /**
+     * @brief Opens (or closes) @ref outboundJournal and @ref receivedStore as @p options configure them.
+     */
+    QExpected<void> openStorage(const DeliveryModuleOptions& options);
+
     /**
      * @brief Serializes node creation to a single in-flight operation.
      */
     std::mutex createNodeMutex;
+
+    /**
+     * @brief @ref createNode that also reports how long parsing the configuration took.
+     */
+    bool createNode(const QString &cfg, std::chrono::steady_clock::duration* parseTime);
+
+    /**
+     * @brief Guards @ref firstPeerAt and @ref lastBootstrap.
+     */
+    std::mutex connectionMutex;
+
+    /**
+     * @brief Signalled when @ref firstPeerAt is set.
+     */
+    std::condition_variable peerConnected;
+
+    /**
+     * @brief When the first connected status arrived since @ref createNode.
+     */
+    std::optional<std::chrono::steady_clock::time_point> firstPeerAt;
+
+    /**
+     * @brief Report of the latest @ref bootstrap.
+     */
+    QJsonObject lastBootstrap;
+
+    /**
+     * @brief Module options taken from the `createNode` configuration; only
+     * accessed under @ref createNodeMutex.
+     */
+    DeliveryModuleOptions moduleOptions;
+
+    /**
+     * @brief Module options read by the dispatcher and send paths, published
+     * from @ref moduleOptions by @ref createNode.
+     */
+    std::atomic<DeliveryModuleOptions::ReceivedPayloadFormat> receivedPayloadFormat{
+        DeliveryModuleOptions::ReceivedPayloadFormat::Base64};
+    std::atomic<uint32_t> maxTransferBytes{0};
+    std::atomic<uint32_t> maxMessageBytes{0};
+
+    /**
+     * @brief Common send path of @ref send, @ref sendBytes and @ref sendWithDeadline.
+     */
+    QExpected<QString> sendPayload(const QString &contentTopic, const QByteArray &payload,
+        std::chrono::milliseconds timeout, CancellationToken* cancellation = nullptr);
     
     /**
-     * @brief Common timeout for FFI operations that complete via callback.
+     * @brief Default timeout for FFI operations that complete via callback.
      */
     static constexpr std::chrono::seconds CALLBACK_TIMEOUT{30};
+
+    /**
+     * @brief Callback timeouts per FFI operation from the module options, in
+     * milliseconds; `0` means @ref CALLBACK_TIMEOUT.
+     */
+    std::array<std::atomic<uint32_t>, static_cast<size_t>(FfiOperation::Count)> callTimeoutsMs{};
+
+    /**
+     * @brief Callback timeout for @p operation.
+     */
+    std::chrono::milliseconds callTimeout(FfiOperation operation) const;
+
+    /**
+     * @brief Tokens of calls currently waiting in @ref sendWithDeadline, for @ref cancelCall.
+     */
+    std::mutex cancellationMutex;
+    QHash<QString, std::shared_ptr<CancellationToken>> cancellationTokens;
+
+    /**
+     * @brief Number of cells in the event ring between the FFI thread and the dispatcher.
+     */
+    static constexpr size_t EVENT_QUEUE_CAPACITY = 8192;
+
+    /**
+     * @brief Event waiting in the ring for the dispatcher thread.
+     *
+     * Either a raw liblogosdelivery event (`raw`) still to be decoded, or an
+     * already built plugin event (`type` + `data`) whose local timestamp is
+     * appended at dispatch.
+     */
+    struct QueuedEvent {
+        QByteArray raw;
+        DeliveryEventType type{DeliveryEventType::MessageSent};
+        QVariantList data;
+        qint64 receivedAtMs{0};
+        std::chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    EventRing<QueuedEvent> eventQueue{EVENT_QUEUE_CAPACITY};
+
+    /**
+     * @brief Slots in the in-flight table; three quarters of them can be tracked at once.
+     */
+    static constexpr size_t INFLIGHT_CAPACITY = 8192;
+
+    /**
+     * @brief Age from which an unfinished send is reported as stuck.
+     */
+    static constexpr std::chrono::seconds INFLIGHT_STUCK_AFTER{30};
+
+    /**
+     * @brief Age at which an unfinished send is dropped from the in-flight table.
+     */
+    static constexpr std::chrono::seconds INFLIGHT_EXPIRE_AFTER{300};
+
+    /**
+     * @brief How often the dispatcher thread expires in-flight entries.
+     */
+    static constexpr std::chrono::seconds INFLIGHT_SWEEP_INTERVAL{1};
+
+    /**
+     * @brief In-flight caps from the module options; slots are released as
+     * @ref inflightTracker retires the sends that took them.
+     */
+    SendAdmission sendAdmission;
+
+    /**
+     * @brief Correlates request ids from `send` with their delivery events.
+     */
+    InflightTracker inflightTracker{INFLIGHT_CAPACITY, INFLIGHT_EXPIRE_AFTER, INFLIGHT_STUCK_AFTER};
+    std::counting_semaphore<> eventsAvailable{0};
+    std::atomic<bool> dispatcherRunning{false};
+    std::thread eventDispatcher;
+
+    /**
+     * @brief Starts the dispatcher thread if it is not running yet.
+     */
+    void startEventDispatcher();
+
+    /**
+     * @brief Stops and joins the dispatcher thread; queued events are dropped.
+     */
+    void stopEventDispatcher();
+
+    /**
+     * @brief Dispatcher thread body: drains the ring, emits events and expires in-flight and
+     * asynchronous sends and idle chunk transfers.
+     */
+    void dispatchEvents();
+
+    /**
+     * @brief Hands an event over to the dispatcher without blocking.
+     *
+     * A dropped event is logged (rate-limited) and counted per event type in
+     * the `dropped` metric.
+     * @return `false` when the ring is full and the event was dropped.
+     */
+    bool enqueueEvent(QueuedEvent&& event);
+
+    /**
+     * @brief Decodes a raw liblogosdelivery event and emits the matching plugin event.
+     * @param queued Ring entry holding the UTF-8 JSON event payload in `raw`.
+     */
+    void handleRawEvent(const QueuedEvent& queued);
+
+    /**
+     * @brief Deadlines of the sends started by @ref sendAsync; expired by the
+     * dispatcher thread and abandoned on destruction.
+     */
+    AsyncCallRegistry asyncCalls;
+
+    /**
+     * @brief Source of local handles returned by @ref sendAsync.
+     */
+    std::atomic<quint64> nextSendHandle{1};
+
+    /**
+     * @brief Appends the JSON envelope expected by `logosdelivery_send` to @p out.
+     *
+     * The envelope is serialized directly, without building a `QJsonObject`,
+     * so batches can be written back to back into one buffer.
+     *
+     * @param out Destination buffer.
+     * @param contentTopic Destination content topic.
+     * @param payload Raw payload bytes, base64-encoded into the envelope.
+     * @param ephemeral Value of the envelope `ephemeral` flag.
+     */
+    static void appendSendEnvelope(QByteArray& out, const QString& contentTopic, const QByteArray& payload, bool ephemeral);
+
+    /**
+     * @brief Common path of @ref subscribeMany and @ref unsubscribeMany; the caller holds @ref contextMutex.
+     * @param operation `FfiOperation::Subscribe` or `FfiOperation::Unsubscribe`.
+     */
+    QExpected<QVariantList> updateSubscriptions(FfiOperation operation, const QStringList &contentTopics);
+
+    /**
+     * @brief Takes an admission slot for a send to @p contentTopic.
+     * @param admissionKey Receives the slot key; stays empty when no cap is configured.
+     * @return Empty when admitted, otherwise the `busy: ...` error for the caller.
+     */
+    QString admitSend(const QString& contentTopic, std::optional<uint64_t>& admissionKey);
+
+    /**
+     * @brief Hands an acknowledged send to @ref inflightTracker, which releases its
+     * admission slot once the send settles; releases it right away if the send
+     * cannot be tracked.
+     */
+    void trackSend(const QString& requestId, std::chrono::steady_clock::time_point startedAt,
+        const std::optional<uint64_t>& admissionKey);
+
+    /**
+     * @brief Releases the admission slot of a send that liblogosdelivery did not accept.
+     */
+    void releaseSend(const std::optional<uint64_t>& admissionKey);
     
+    /**
+     * @brief Guards `logosAPI` and @ref deliveryClient against replacement while emitting.
+     */
+    std::mutex logosApiMutex;
+
+    /**
+     * @brief `delivery_module` client of the current `logosAPI`, resolved by @ref initLogos.
+     */
+    LogosAPIClient* deliveryClient{nullptr};
+
+    /**
+     * @brief Clients named by topic routes, resolved on first use; guarded by @ref logosApiMutex.
+     */
+    QHash<QString, LogosAPIClient*> routedClients;
+
+    /**
+     * @brief Content topic to client routes registered with @ref addTopicRoute.
+     */
+    TopicRouter topicRouter;
+
+    /**
+     * @brief Drops repeated received messages; configured from the module options.
+     */
+    MessageDedup receivedDedup;
+
+    /**
+     * @brief Answers repeated node info, config and version queries without an FFI call.
+     *
+     * Volatile entries are dropped on every connection state change and all
+     * entries on @ref createNode.
+     */
+    mutable NodeInfoCache nodeInfoCache;
+
+    /**
+     * @brief Number of `getClient` lookups performed; stays flat while events flow.
+     */
+    std::atomic<quint64> clientLookups{0};
+
+    /**
+     * @brief Looks up a Logos API client by name; caller holds @ref logosApiMutex.
+     */
+    LogosAPIClient* resolveClient(const QString& clientName);
+
     /**
      * @brief Forwards normalized events to the registered Logos API client.
-     * @param eventName Canonical event name.
+     * @param type Plugin event; its name is taken from @ref deliveryEventName.
      * @param data Event payload list.
+     * @param enqueuedAt When the event entered the ring, for the event latency metric.
+     * @param clients Clients routed for the event's topic; empty sends it to `delivery_module`.
      */
-    void emitEvent(const QString& eventName, const QVariantList& data);
+    void emitEvent(DeliveryEventType type, const QVariantList& data, std::chrono::steady_clock::time_point enqueuedAt,
+        const QStringList& clients = {});
     
     /**
      * @brief Global C callback used by liblogosdelivery to report async events.
      *
      * Expected event payload format is a JSON document containing an `eventType`
-     * discriminator and event-specific fields.
+     * discriminator and event-specific fields. The payload is only copied into
+     * the event ring here; decoding happens on the dispatcher thread.
      *
      * @param callerRet FFI return code associated with callback dispatch.
      * @param msg UTF-8 JSON event payload buffer.
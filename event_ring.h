@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free multi-producer / multi-consumer ring.
+ *
+ * Each cell carries a sequence number that tells producers and consumers
+ * whether it is free to write or ready to read (D. Vyukov's bounded queue),
+ * so neither side ever takes a lock or allocates after construction. Pushing
+ * into a full ring fails immediately instead of blocking the producer; the
+ * drop is counted so bursts stay observable.
+ *
+ * @tparam T Movable element type.
+ */
+template <typename T>
+class EventRing {
+public:
+    /**
+     * @brief Snapshot of the ring counters.
+     */
+    struct Stats {
+        size_t capacity{0};
+        size_t depth{0};
+        size_t highWater{0};
+        uint64_t pushed{0};
+        uint64_t popped{0};
+        uint64_t dropped{0};
+    };
+
+    /**
+     * @param capacity Requested number of cells, rounded up to a power of two.
+     */
+    explicit EventRing(size_t capacity)
+        : m_capacity(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity))
+        , m_mask(m_capacity - 1)
+        , m_cells(std::make_unique<Cell[]>(m_capacity))
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    EventRing(const EventRing&) = delete;
+    EventRing& operator=(const EventRing&) = delete;
+
+    /**
+     * @brief Moves @p item into the ring.
+     * @return `false` (and counts a drop) when the ring is full.
+     */
+    bool tryPush(T&& item)
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        m_pushed.fetch_add(1, std::memory_order_relaxed);
+        const size_t dequeued = m_dequeuePos.load(std::memory_order_relaxed);
+        if (pos + 1 > dequeued) {
+            updateHighWater(pos + 1 - dequeued);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Moves the oldest element into @p out.
+     * @return `false` when the ring is empty.
+     */
+    bool tryPop(T& out)
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        out = std::move(cell->value);
+        cell->value = T{};
+        cell->sequence.store(pos + m_capacity, std::memory_order_release);
+        m_popped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+    /**
+     * @brief Approximate number of queued elements.
+     */
+    size_t depth() const
+    {
+        const size_t enqueued = m_enqueuePos.load(std::memory_order_relaxed);
+        const size_t dequeued = m_dequeuePos.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    Stats stats() const
+    {
+        Stats snapshot;
+        snapshot.capacity = m_capacity;
+        snapshot.depth = depth();
+        snapshot.highWater = m_highWater.load(std::memory_order_relaxed);
+        snapshot.pushed = m_pushed.load(std::memory_order_relaxed);
+        snapshot.popped = m_popped.load(std::memory_order_relaxed);
+        snapshot.dropped = m_dropped.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    static size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    void updateHighWater(size_t depth)
+    {
+        size_t current = m_highWater.load(std::memory_order_relaxed);
+        while (depth > current
+               && !m_highWater.compare_exchange_weak(current, depth, std::memory_order_relaxed)) {
+        }
+    }
+
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+
+    alignas(kCacheLine) std::atomic<size_t> m_enqueuePos{0};
+    alignas(kCacheLine) std::atomic<size_t> m_dequeuePos{0};
+    alignas(kCacheLine) std::atomic<size_t> m_highWater{0};
+    std::atomic<uint64_t> m_pushed{0};
+    std::atomic<uint64_t> m_popped{0};
+    std::atomic<uint64_t> m_dropped{0};
+};
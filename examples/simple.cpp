@@ -3,7 +3,9 @@
 #include <QDebug>
 #include <QFileInfo>
 #include <QFile>
+#include <QJsonArray>
 #include <QJsonDocument>
+#include <QJsonObject>
 #include <QCommandLineParser>
 #include <QString>
 #include <QStringList>
@@ -88,13 +90,18 @@ int main(int argc, char *argv[])
         return -1;
     }
 
-    delivery->createNode(QString::fromUtf8(jsonData));
-    delivery->start();
+    QString contentTopicOfInterest = "/simple-example/2/delivery/proto";
+    auto startup = delivery->bootstrap(QString::fromUtf8(jsonData), QStringList{contentTopicOfInterest});
+    if (startup.isErr()) {
+        qDebug() << "Failed to start node:" << startup.error();
+        return -1;
+    }
 
     qDebug() << "Plugin loaded. Type a message to send, or 'exit' to quit.";
+    qDebug() << "Startup timings:" << startup.value();
 
-    QString contentTopicOfInterest = "/simple-example/2/delivery/proto";
-    if (!delivery->subscribe(contentTopicOfInterest)) {
+    QJsonObject report = QJsonDocument::fromJson(startup.value().toUtf8()).object();
+    if (!report.value("failedTopics").toArray().isEmpty()) {
         qDebug() << "Failed to subscribe to topic:" << contentTopicOfInterest;
         return -1;
     }
@@ -0,0 +1,225 @@
+#include "inflight_tracker.h"
+
+#include <cstring>
+
+#include "delivery_metrics.h"
+
+namespace {
+size_t roundUpToPowerOfTwo(size_t value)
+{
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+} // namespace
+
+InflightTracker::InflightTracker(size_t capacity, Clock::duration expireAfter, Clock::duration stuckAfter)
+    : m_capacity(roundUpToPowerOfTwo(capacity < 4 ? 4 : capacity))
+    , m_mask(m_capacity - 1)
+    , m_maxEntries(m_capacity - m_capacity / 4)
+    , m_expireAfter(expireAfter)
+    , m_stuckAfter(stuckAfter)
+    , m_entries(std::make_unique<Entry[]>(m_capacity))
+{
+    m_counters.capacity = m_maxEntries;
+}
+
+uint64_t InflightTracker::hashOf(std::string_view requestId)
+{
+    // FNV-1a, finalized so that the low bits used for probing are well mixed
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : requestId) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash == 0 ? 1 : hash;
+}
+
+InflightTracker::Entry* InflightTracker::find(std::string_view requestId, uint64_t hash)
+{
+    for (size_t index = hash & m_mask;; index = (index + 1) & m_mask) {
+        Entry& entry = m_entries[index];
+        if (entry.hash == 0) {
+            return nullptr;
+        }
+        if (entry.hash == hash && entry.keyLength == requestId.size()
+            && std::memcmp(entry.key, requestId.data(), requestId.size()) == 0) {
+            return &entry;
+        }
+    }
+}
+
+InflightTracker::Entry* InflightTracker::insert(std::string_view requestId, uint64_t hash, Clock::time_point now)
+{
+    if (requestId.empty() || requestId.size() > kMaxRequestIdLength || m_size >= m_maxEntries) {
+        ++m_counters.overflowed;
+        return nullptr;
+    }
+    size_t index = hash & m_mask;
+    while (m_entries[index].hash != 0) {
+        index = (index + 1) & m_mask;
+    }
+    Entry& entry = m_entries[index];
+    entry = Entry{};
+    entry.hash = hash;
+    entry.firstSeen = now;
+    entry.keyLength = static_cast<uint8_t>(requestId.size());
+    std::memcpy(entry.key, requestId.data(), requestId.size());
+    ++m_size;
+    return &entry;
+}
+
+InflightTracker::Entry* InflightTracker::findOrInsert(std::string_view requestId, Clock::time_point now)
+{
+    const uint64_t hash = hashOf(requestId);
+    if (Entry* entry = find(requestId, hash)) {
+        return entry;
+    }
+    return insert(requestId, hash, now);
+}
+
+void InflightTracker::erase(Entry* entry)
+{
+    // Backward-shift deletion: pull later members of the probe run into the gap
+    size_t gap = static_cast<size_t>(entry - m_entries.get());
+    for (size_t index = (gap + 1) & m_mask; m_entries[index].hash != 0; index = (index + 1) & m_mask) {
+        const size_t home = m_entries[index].hash & m_mask;
+        // Distance from home; an entry may move into the gap only if that keeps it reachable
+        if (((index - home) & m_mask) >= ((index - gap) & m_mask)) {
+            m_entries[gap] = m_entries[index];
+            gap = index;
+        }
+    }
+    m_entries[gap].hash = 0;
+    --m_size;
+}
+
+void InflightTracker::setRetireHandler(RetireHandler handler)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_retireHandler = std::move(handler);
+}
+
+void InflightTracker::retire(Entry* entry, Clock::duration age)
+{
+    if ((entry->flags & Admitted) && m_retireHandler) {
+        m_retireHandler(entry->admissionKey, age);
+    }
+    erase(entry);
+}
+
+void InflightTracker::settle(Entry* entry)
+{
+    if (!(entry->flags & Submitted) || !(entry->flags & (Sent | Failed))) {
+        return;
+    }
+    const Clock::duration age = entry->finishedAt - entry->submittedAt;
+    DeliveryMetrics::instance().recordDelivery((entry->flags & Sent) ? DeliveryStage::Sent : DeliveryStage::Error, age);
+    retire(entry, age);
+}
+
+bool InflightTracker::submit(std::string_view requestId, Clock::time_point submittedAt,
+    std::optional<uint64_t> admissionKey)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_counters.submitted;
+    Entry* entry = findOrInsert(requestId, submittedAt);
+    if (!entry || (entry->flags & Submitted)) {
+        return false;
+    }
+    entry->flags |= Submitted;
+    entry->submittedAt = submittedAt;
+    entry->firstSeen = submittedAt;
+    if (admissionKey) {
+        entry->flags |= Admitted;
+        entry->admissionKey = *admissionKey;
+    }
+    if (entry->flags & Propagated) {
+        DeliveryMetrics::instance().recordDelivery(DeliveryStage::Propagated, entry->propagatedAt - submittedAt);
+    }
+    settle(entry);
+    return true;
+}
+
+void InflightTracker::propagated(std::string_view requestId, Clock::time_point at)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_counters.propagated;
+    Entry* entry = findOrInsert(requestId, at);
+    if (!entry || (entry->flags & Propagated)) {
+        return;
+    }
+    entry->flags |= Propagated;
+    entry->propagatedAt = at;
+    if (entry->flags & Submitted) {
+        DeliveryMetrics::instance().recordDelivery(DeliveryStage::Propagated, at - entry->submittedAt);
+    }
+}
+
+void InflightTracker::sent(std::string_view requestId, Clock::time_point at)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_counters.sent;
+    Entry* entry = findOrInsert(requestId, at);
+    if (!entry || (entry->flags & (Sent | Failed))) {
+        return;
+    }
+    entry->flags |= Sent;
+    entry->finishedAt = at;
+    settle(entry);
+}
+
+void InflightTracker::failed(std::string_view requestId, Clock::time_point at)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_counters.failed;
+    Entry* entry = findOrInsert(requestId, at);
+    if (!entry || (entry->flags & (Sent | Failed))) {
+        return;
+    }
+    entry->flags |= Failed;
+    entry->finishedAt = at;
+    settle(entry);
+}
+
+size_t InflightTracker::expire(Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t removed = 0;
+    for (size_t index = 0; index < m_capacity;) {
+        Entry& entry = m_entries[index];
+        if (entry.hash == 0 || now - entry.firstSeen < m_expireAfter) {
+            ++index;
+            continue;
+        }
+        if (entry.flags & Submitted) {
+            ++m_counters.expired;
+        } else {
+            // Events whose send was never acknowledged to this plugin
+            ++m_counters.orphaned;
+        }
+        // An expired send says little about typical completion time
+        retire(&entry, Clock::duration::zero());
+        ++removed;
+        // The slot may now hold a shifted entry; look at it again
+    }
+    return removed;
+}
+
+InflightTracker::Stats InflightTracker::stats(Clock::time_point now) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats snapshot = m_counters;
+    snapshot.tracked = m_size;
+    for (size_t index = 0; index < m_capacity; ++index) {
+        const Entry& entry = m_entries[index];
+        if (entry.hash != 0 && (entry.flags & Submitted) && now - entry.submittedAt >= m_stuckAfter) {
+            ++snapshot.stuck;
+        }
+    }
+    return snapshot;
+}
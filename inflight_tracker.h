@@ -0,0 +1,134 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+/**
+ * @brief Bounded table of sent messages waiting for their delivery events.
+ *
+ * Correlates the request id returned by `send` with the later
+ * `message_propagated`, `message_sent` and `message_error` events and records
+ * the time from the `send` call to each of them in DeliveryMetrics. Events
+ * may overtake the `send` acknowledgement, so an event for an unknown id is
+ * parked and matched when the id is submitted.
+ *
+ * The table is a fixed array with linear probing and backward-shift deletion,
+ * so memory stays constant and no tombstones build up under sustained load.
+ * When it is three quarters full, new ids are not tracked and only counted.
+ * Requests that never reach a terminal event are removed by @ref expire.
+ */
+class InflightTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Longest request id that is tracked; longer ids are counted as overflow.
+     */
+    static constexpr size_t kMaxRequestIdLength = 72;
+
+    /**
+     * @brief Counter snapshot; `tracked` and `stuck` describe the table right now.
+     */
+    struct Stats {
+        size_t capacity{0};
+        size_t tracked{0};
+        size_t stuck{0};
+        uint64_t submitted{0};
+        uint64_t propagated{0};
+        uint64_t sent{0};
+        uint64_t failed{0};
+        uint64_t expired{0};
+        uint64_t orphaned{0};
+        uint64_t overflowed{0};
+    };
+
+    /**
+     * @param capacity Number of slots, rounded up to a power of two.
+     * @param expireAfter Age at which an unfinished request is dropped by @ref expire.
+     * @param stuckAfter Age from which a pending request counts as stuck.
+     */
+    InflightTracker(size_t capacity, Clock::duration expireAfter, Clock::duration stuckAfter);
+
+    InflightTracker(const InflightTracker&) = delete;
+    InflightTracker& operator=(const InflightTracker&) = delete;
+
+    /**
+     * @brief Called under the table lock when a request submitted with an
+     * admission key leaves the table, with how long it was in flight (zero
+     * when it expired).
+     *
+     * Set once before the first @ref submit.
+     */
+    using RetireHandler = std::function<void(uint64_t admissionKey, Clock::duration age)>;
+    void setRetireHandler(RetireHandler handler);
+
+    /**
+     * @brief Starts tracking @p requestId, sent at @p submittedAt.
+     * @param admissionKey Handed to the retire handler once the request leaves the table.
+     * @return `false` if the request is not tracked (table full or id already
+     * submitted); the retire handler will then not run for it.
+     */
+    bool submit(std::string_view requestId, Clock::time_point submittedAt,
+        std::optional<uint64_t> admissionKey = std::nullopt);
+
+    void propagated(std::string_view requestId, Clock::time_point at);
+    void sent(std::string_view requestId, Clock::time_point at);
+    void failed(std::string_view requestId, Clock::time_point at);
+
+    /**
+     * @brief Drops requests older than the expiry age.
+     * @return Number of removed entries.
+     */
+    size_t expire(Clock::time_point now);
+
+    Stats stats(Clock::time_point now) const;
+
+private:
+    enum Flag : uint8_t {
+        Submitted = 1u << 0,
+        Propagated = 1u << 1,
+        Sent = 1u << 2,
+        Failed = 1u << 3,
+        Admitted = 1u << 4,
+    };
+
+    struct Entry {
+        uint64_t hash{0}; // 0 marks an empty slot
+        Clock::time_point firstSeen;
+        Clock::time_point submittedAt;
+        Clock::time_point propagatedAt;
+        Clock::time_point finishedAt;
+        uint64_t admissionKey{0};
+        uint8_t flags{0};
+        uint8_t keyLength{0};
+        char key[kMaxRequestIdLength];
+    };
+
+    static uint64_t hashOf(std::string_view requestId);
+
+    // Callers hold m_mutex
+    Entry* find(std::string_view requestId, uint64_t hash);
+    Entry* insert(std::string_view requestId, uint64_t hash, Clock::time_point now);
+    Entry* findOrInsert(std::string_view requestId, Clock::time_point now);
+    void erase(Entry* entry);
+    void settle(Entry* entry);
+    void retire(Entry* entry, Clock::duration age);
+
+    const size_t m_capacity;
+    const size_t m_mask;
+    const size_t m_maxEntries;
+    const Clock::duration m_expireAfter;
+    const Clock::duration m_stuckAfter;
+    std::unique_ptr<Entry[]> m_entries;
+    size_t m_size{0};
+    RetireHandler m_retireHandler;
+
+    mutable std::mutex m_mutex;
+    Stats m_counters;
+};
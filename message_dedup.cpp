@@ -0,0 +1,197 @@
+#include "message_dedup.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+size_t roundUpToPowerOfTwo(size_t value)
+{
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+uint64_t mix(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+} // namespace
+
+void MessageDedup::configure(std::chrono::milliseconds window, size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_window = window;
+    m_head = 0;
+    m_size = 0;
+    m_generationStart = Clock::now();
+    if (window.count() <= 0 || capacity == 0) {
+        m_enabled.store(false, std::memory_order_relaxed);
+        m_capacity = 0;
+        m_entries.reset();
+        m_index.reset();
+        m_bloomWords = 0;
+        m_bloomCurrent.reset();
+        m_bloomPrevious.reset();
+        return;
+    }
+
+    m_capacity = roundUpToPowerOfTwo(capacity);
+    m_entries = std::make_unique<Entry[]>(m_capacity);
+    m_indexMask = m_capacity * 2 - 1;
+    m_index = std::make_unique<uint32_t[]>(m_capacity * 2);
+    std::fill_n(m_index.get(), m_capacity * 2, kEmpty);
+
+    m_bloomWords = roundUpToPowerOfTwo(std::max<size_t>(1, m_capacity * kBloomBitsPerEntry / 64));
+    m_bloomCurrent = std::make_unique<uint64_t[]>(m_bloomWords);
+    m_bloomPrevious = std::make_unique<uint64_t[]>(m_bloomWords);
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+MessageDedup::Fingerprint MessageDedup::fingerprintOf(std::string_view messageHash)
+{
+    // Two FNV-1a lanes with different bases, each finalized
+    uint64_t high = 14695981039346656037ull;
+    uint64_t low = 0x84222325cbf29ce4ull;
+    for (char c : messageHash) {
+        const auto byte = static_cast<unsigned char>(c);
+        high = (high ^ byte) * 1099511628211ull;
+        low = (low ^ byte) * 0x100000001b3ull ^ (low >> 29);
+    }
+    return Fingerprint{mix(high), mix(low ^ messageHash.size())};
+}
+
+void MessageDedup::rotateBloom(Clock::time_point now)
+{
+    const Clock::duration age = now - m_generationStart;
+    if (age < m_window) {
+        return;
+    }
+    if (age >= 2 * m_window) {
+        std::memset(m_bloomPrevious.get(), 0, m_bloomWords * sizeof(uint64_t));
+    } else {
+        std::swap(m_bloomCurrent, m_bloomPrevious);
+    }
+    std::memset(m_bloomCurrent.get(), 0, m_bloomWords * sizeof(uint64_t));
+    m_generationStart = now;
+}
+
+bool MessageDedup::bloomContains(const Fingerprint& fingerprint) const
+{
+    const size_t bitMask = m_bloomWords * 64 - 1;
+    bool inCurrent = true;
+    bool inPrevious = true;
+    for (size_t i = 0; i < kBloomProbes && (inCurrent || inPrevious); ++i) {
+        const size_t bit = (fingerprint.high + i * (fingerprint.low | 1)) & bitMask;
+        const uint64_t mask = uint64_t{1} << (bit & 63);
+        inCurrent = inCurrent && (m_bloomCurrent[bit >> 6] & mask);
+        inPrevious = inPrevious && (m_bloomPrevious[bit >> 6] & mask);
+    }
+    return inCurrent || inPrevious;
+}
+
+void MessageDedup::bloomInsert(const Fingerprint& fingerprint)
+{
+    const size_t bitMask = m_bloomWords * 64 - 1;
+    for (size_t i = 0; i < kBloomProbes; ++i) {
+        const size_t bit = (fingerprint.high + i * (fingerprint.low | 1)) & bitMask;
+        m_bloomCurrent[bit >> 6] |= uint64_t{1} << (bit & 63);
+    }
+}
+
+size_t MessageDedup::findSlot(const Fingerprint& fingerprint) const
+{
+    for (size_t slot = fingerprint.low & m_indexMask;; slot = (slot + 1) & m_indexMask) {
+        const uint32_t position = m_index[slot];
+        if (position == kEmpty || m_entries[position].fingerprint == fingerprint) {
+            return slot;
+        }
+    }
+}
+
+void MessageDedup::eraseSlot(size_t slot)
+{
+    // Backward-shift deletion, as in InflightTracker
+    size_t gap = slot;
+    for (size_t index = (gap + 1) & m_indexMask; m_index[index] != kEmpty; index = (index + 1) & m_indexMask) {
+        const size_t home = m_entries[m_index[index]].fingerprint.low & m_indexMask;
+        if (((index - home) & m_indexMask) >= ((index - gap) & m_indexMask)) {
+            m_index[gap] = m_index[index];
+            gap = index;
+        }
+    }
+    m_index[gap] = kEmpty;
+}
+
+void MessageDedup::insert(const Fingerprint& fingerprint, Clock::time_point now)
+{
+    const size_t ringMask = m_capacity - 1;
+    if (m_size == m_capacity) {
+        // Forget the oldest entry, which sits where the next one goes
+        eraseSlot(findSlot(m_entries[m_head].fingerprint));
+        --m_size;
+    }
+    m_entries[m_head] = Entry{fingerprint, now};
+    m_index[findSlot(fingerprint)] = static_cast<uint32_t>(m_head);
+    m_head = (m_head + 1) & ringMask;
+    ++m_size;
+}
+
+bool MessageDedup::isDuplicate(std::string_view messageHash, Clock::time_point now)
+{
+    if (!enabled() || messageHash.empty()) {
+        return false;
+    }
+    const Fingerprint fingerprint = fingerprintOf(messageHash);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_capacity) {
+        return false;
+    }
+    rotateBloom(now);
+
+    // Entries leave the exact table in arrival order once they fall out of the window
+    const size_t ringMask = m_capacity - 1;
+    while (m_size > 0) {
+        const size_t oldest = (m_head - m_size) & ringMask;
+        if (now - m_entries[oldest].seenAt < m_window) {
+            break;
+        }
+        eraseSlot(findSlot(m_entries[oldest].fingerprint));
+        --m_size;
+    }
+
+    if (bloomContains(fingerprint)) {
+        if (m_index[findSlot(fingerprint)] != kEmpty) {
+            m_duplicates.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        m_falsePositives.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bloomInsert(fingerprint);
+    insert(fingerprint, now);
+    m_unique.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+MessageDedup::Stats MessageDedup::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats snapshot;
+    snapshot.enabled = enabled();
+    snapshot.window = std::chrono::duration_cast<std::chrono::milliseconds>(m_window);
+    snapshot.capacity = m_capacity;
+    snapshot.tracked = m_size;
+    snapshot.unique = m_unique.load(std::memory_order_relaxed);
+    snapshot.duplicates = m_duplicates.load(std::memory_order_relaxed);
+    snapshot.falsePositives = m_falsePositives.load(std::memory_order_relaxed);
+    return snapshot;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+/**
+ * @brief Drops received messages whose hash was already seen within a time window.
+ *
+ * Two structures with fixed memory work together:
+ * - a rotating Bloom filter of two generations, each covering one window,
+ *   answers "definitely new" for most messages without touching the table;
+ * - an exact table of the most recent message fingerprints (128 bits, so
+ *   collisions are negligible) confirms every Bloom hit, with first-seen
+ *   times to enforce the window. When full it forgets the oldest entry.
+ *
+ * A message is dropped only when the exact table confirms it. A Bloom hit
+ * the table cannot confirm (a false positive, or an entry that already left
+ * the table) is delivered and counted in `falsePositives`.
+ */
+class MessageDedup {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        bool enabled{false};
+        std::chrono::milliseconds window{0};
+        size_t capacity{0};
+        size_t tracked{0};
+        uint64_t unique{0};
+        uint64_t duplicates{0};
+        uint64_t falsePositives{0};
+    };
+
+    /**
+     * @brief Resets the filter; a zero @p window disables it.
+     * @param capacity Messages remembered exactly, rounded up to a power of two.
+     */
+    void configure(std::chrono::milliseconds window, size_t capacity);
+
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Records @p messageHash and reports whether it is a duplicate to drop.
+     */
+    bool isDuplicate(std::string_view messageHash, Clock::time_point now);
+
+    Stats stats() const;
+
+private:
+    struct Fingerprint {
+        uint64_t high{0};
+        uint64_t low{0};
+
+        bool operator==(const Fingerprint& other) const { return high == other.high && low == other.low; }
+    };
+
+    struct Entry {
+        Fingerprint fingerprint;
+        Clock::time_point seenAt;
+    };
+
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+    static constexpr size_t kBloomBitsPerEntry = 10;
+    static constexpr size_t kBloomProbes = 7;
+
+    static Fingerprint fingerprintOf(std::string_view messageHash);
+
+    // Callers hold m_mutex
+    void rotateBloom(Clock::time_point now);
+    bool bloomContains(const Fingerprint& fingerprint) const;
+    void bloomInsert(const Fingerprint& fingerprint);
+    size_t findSlot(const Fingerprint& fingerprint) const;
+    void eraseSlot(size_t slot);
+    void insert(const Fingerprint& fingerprint, Clock::time_point now);
+
+    mutable std::mutex m_mutex;
+    std::atomic<bool> m_enabled{false};
+    Clock::duration m_window{0};
+
+    // Exact table: entries in arrival order, with an open-addressing index over them
+    size_t m_capacity{0};
+    std::unique_ptr<Entry[]> m_entries;
+    size_t m_head{0};
+    size_t m_size{0};
+    size_t m_indexMask{0};
+    std::unique_ptr<uint32_t[]> m_index;
+
+    // Bloom generations: bits inserted during the current and the previous window
+    size_t m_bloomWords{0};
+    std::unique_ptr<uint64_t[]> m_bloomCurrent;
+    std::unique_ptr<uint64_t[]> m_bloomPrevious;
+    Clock::time_point m_generationStart;
+
+    std::atomic<uint64_t> m_unique{0};
+    std::atomic<uint64_t> m_duplicates{0};
+    std::atomic<uint64_t> m_falsePositives{0};
+};
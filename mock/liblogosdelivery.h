@@ -0,0 +1,49 @@
+/*
+ * Loopback stand-in for the liblogosdelivery C API (logos-delivery).
+ *
+ * Declares the same surface the delivery module uses so the plugin can be built
+ * and exercised without the Nim library or a network. Only used when the
+ * LOGOS_DELIVERY_MODULE_USE_MOCK CMake option is enabled.
+ */
+#ifndef LIBLOGOSDELIVERY_MOCK_H
+#define LIBLOGOSDELIVERY_MOCK_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RET_OK 0
+#define RET_ERR 1
+#define RET_MISSING_CALLBACK 2
+
+typedef void (*FFICallBack)(int callerRet, const char *msg, size_t len, void *userData);
+
+void *logosdelivery_create_node(const char *configJson, FFICallBack callback, void *userData);
+int logosdelivery_destroy(void *ctx, FFICallBack callback, void *userData);
+void logosdelivery_set_event_callback(void *ctx, FFICallBack callback, void *userData);
+
+int logosdelivery_start_node(void *ctx, FFICallBack callback, void *userData);
+int logosdelivery_stop_node(void *ctx, FFICallBack callback, void *userData);
+
+int logosdelivery_subscribe(void *ctx, FFICallBack callback, void *userData, const char *contentTopic);
+int logosdelivery_unsubscribe(void *ctx, FFICallBack callback, void *userData, const char *contentTopic);
+int logosdelivery_send(void *ctx, FFICallBack callback, void *userData, const char *messageJson);
+
+int logosdelivery_get_available_node_info_ids(void *ctx, FFICallBack callback, void *userData);
+int logosdelivery_get_node_info(void *ctx, FFICallBack callback, void *userData, const char *nodeInfoId);
+int logosdelivery_get_available_configs(void *ctx, FFICallBack callback, void *userData);
+
+/*
+ * Mock-only hook: delivers `eventJson` to the registered event callback
+ * synchronously on the calling thread, e.g. to benchmark event ingestion.
+ * Returns RET_ERR when no event callback is registered.
+ */
+int logosdelivery_mock_inject_event(void *ctx, const char *eventJson, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBLOGOSDELIVERY_MOCK_H */
@@ -0,0 +1,515 @@
+// Loopback implementation of the liblogosdelivery C API.
+//
+// Every call returns immediately and answers through its callback from a small
+// pool of callback threads after a configurable latency. Sends are looped back
+// as `message_propagated`, `message_sent` and, for subscribed content topics,
+// `message_received` events. Behaviour is tuned with flat keys in the
+// create_node configuration, or with the matching environment variables
+// (which take precedence):
+//
+// | Config key            | Environment variable                 | Default |
+// |-----------------------|--------------------------------------|---------|
+// | `mockLatencyUs`       | `LOGOS_DELIVERY_MOCK_LATENCY_US`     | `200`   |
+// | `mockJitterUs`        | `LOGOS_DELIVERY_MOCK_JITTER_US`      | `0`     |
+// | `mockErrorRate`       | `LOGOS_DELIVERY_MOCK_ERROR_RATE`     | `0`     |
+// | `mockCallbackThreads` | `LOGOS_DELIVERY_MOCK_CALLBACK_THREADS` | `1`   |
+
+#include "liblogosdelivery.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct MockOptions {
+    int64_t latencyUs{200};
+    int64_t jitterUs{0};
+    double errorRate{0.0};
+    int callbackThreads{1};
+};
+
+// Reads a numeric value for a flat top-level key; good enough for mock settings.
+bool readNumber(const char* json, const char* key, double& value)
+{
+    if (!json) {
+        return false;
+    }
+    const std::string needle = std::string("\"") + key + "\"";
+    const char* found = std::strstr(json, needle.c_str());
+    if (!found) {
+        return false;
+    }
+    const char* colon = std::strchr(found + needle.size(), ':');
+    if (!colon) {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtod(colon + 1, &end);
+    return end != colon + 1;
+}
+
+bool readEnv(const char* name, double& value)
+{
+    const char* text = std::getenv(name);
+    if (!text || !*text) {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtod(text, &end);
+    return end != text;
+}
+
+MockOptions parseOptions(const char* configJson)
+{
+    MockOptions options;
+    double value = 0;
+    if (readNumber(configJson, "mockLatencyUs", value)) options.latencyUs = static_cast<int64_t>(value);
+    if (readNumber(configJson, "mockJitterUs", value)) options.jitterUs = static_cast<int64_t>(value);
+    if (readNumber(configJson, "mockErrorRate", value)) options.errorRate = value;
+    if (readNumber(configJson, "mockCallbackThreads", value)) options.callbackThreads = static_cast<int>(value);
+
+    if (readEnv("LOGOS_DELIVERY_MOCK_LATENCY_US", value)) options.latencyUs = static_cast<int64_t>(value);
+    if (readEnv("LOGOS_DELIVERY_MOCK_JITTER_US", value)) options.jitterUs = static_cast<int64_t>(value);
+    if (readEnv("LOGOS_DELIVERY_MOCK_ERROR_RATE", value)) options.errorRate = value;
+    if (readEnv("LOGOS_DELIVERY_MOCK_CALLBACK_THREADS", value)) options.callbackThreads = static_cast<int>(value);
+
+    if (options.latencyUs < 0) options.latencyUs = 0;
+    if (options.jitterUs < 0) options.jitterUs = 0;
+    if (options.callbackThreads < 1) options.callbackThreads = 1;
+    return options;
+}
+
+// Returns the raw (still JSON-escaped) contents of a top-level string field.
+std::string rawStringField(const char* json, const char* key)
+{
+    const std::string needle = std::string("\"") + key + "\"";
+    const char* found = json ? std::strstr(json, needle.c_str()) : nullptr;
+    if (!found) {
+        return {};
+    }
+    const char* pos = std::strchr(found + needle.size(), ':');
+    if (!pos) {
+        return {};
+    }
+    ++pos;
+    while (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r') {
+        ++pos;
+    }
+    if (*pos != '"') {
+        return {};
+    }
+    const char* start = ++pos;
+    while (*pos && *pos != '"') {
+        if (*pos == '\\' && pos[1]) {
+            ++pos;
+        }
+        ++pos;
+    }
+    return std::string(start, static_cast<size_t>(pos - start));
+}
+
+// Resolves the simple escapes a content topic can contain.
+std::string unescapeSimple(const std::string& raw)
+{
+    std::string out;
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] == '\\' && i + 1 < raw.size()) {
+            ++i;
+        }
+        out.push_back(raw[i]);
+    }
+    return out;
+}
+
+std::string escapeSimple(const char* text)
+{
+    std::string out;
+    for (const char* c = text; c && *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out.push_back('\\');
+        }
+        out.push_back(*c);
+    }
+    return out;
+}
+
+std::string hex(uint64_t value, int digits)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    std::string out(static_cast<size_t>(digits), '0');
+    for (int i = digits - 1; i >= 0 && value; --i) {
+        out[static_cast<size_t>(i)] = hexDigits[value & 0xf];
+        value >>= 4;
+    }
+    return out;
+}
+
+class MockNode {
+public:
+    explicit MockNode(const MockOptions& options) : m_options(options), m_random(std::random_device{}())
+    {
+        for (int i = 0; i < m_options.callbackThreads; ++i) {
+            m_workers.emplace_back([this] { run(); });
+        }
+    }
+
+    ~MockNode()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    void setEventCallback(FFICallBack callback, void* userData)
+    {
+        std::lock_guard<std::mutex> lock(m_eventMutex);
+        m_eventCallback = callback;
+        m_eventUserData = userData;
+    }
+
+    bool emitEvent(const std::string& json)
+    {
+        FFICallBack callback = nullptr;
+        void* userData = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_eventMutex);
+            callback = m_eventCallback;
+            userData = m_eventUserData;
+        }
+        if (!callback) {
+            return false;
+        }
+        callback(RET_OK, json.data(), json.size(), userData);
+        return true;
+    }
+
+    // Answers `callback` after the configured latency, failing at the configured rate.
+    int respond(FFICallBack callback, void* userData, std::function<std::string(bool& ok)> produce, int delaySteps = 1)
+    {
+        if (!callback) {
+            return RET_MISSING_CALLBACK;
+        }
+        schedule(delaySteps, [this, callback, userData, produce = std::move(produce)] {
+            bool ok = true;
+            std::string message;
+            if (injectFailure()) {
+                ok = false;
+                message = "mock: injected failure";
+            } else {
+                message = produce(ok);
+            }
+            callback(ok ? RET_OK : RET_ERR, message.data(), message.size(), userData);
+        });
+        return RET_OK;
+    }
+
+    void schedule(int delaySteps, std::function<void()> task)
+    {
+        const auto due = Clock::now() + std::chrono::microseconds(delayUs() * delaySteps);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push(Task{due, m_sequence++, std::move(task)});
+        }
+        m_wake.notify_one();
+    }
+
+    std::atomic<bool> started{false};
+    std::atomic<uint64_t> nextRequest{1};
+
+    bool isSubscribed(const std::string& topic)
+    {
+        std::lock_guard<std::mutex> lock(m_topicsMutex);
+        return m_topics.count(topic) > 0;
+    }
+
+    void setSubscribed(const std::string& topic, bool subscribed)
+    {
+        std::lock_guard<std::mutex> lock(m_topicsMutex);
+        if (subscribed) {
+            m_topics.insert(topic);
+        } else {
+            m_topics.erase(topic);
+        }
+    }
+
+private:
+    struct Task {
+        Clock::time_point due;
+        uint64_t sequence;
+        std::function<void()> run;
+
+        bool operator>(const Task& other) const
+        {
+            return due != other.due ? due > other.due : sequence > other.sequence;
+        }
+    };
+
+    int64_t delayUs()
+    {
+        if (m_options.jitterUs == 0) {
+            return m_options.latencyUs;
+        }
+        std::lock_guard<std::mutex> lock(m_randomMutex);
+        std::uniform_int_distribution<int64_t> jitter(-m_options.jitterUs, m_options.jitterUs);
+        const int64_t delay = m_options.latencyUs + jitter(m_random);
+        return delay < 0 ? 0 : delay;
+    }
+
+    bool injectFailure()
+    {
+        if (m_options.errorRate <= 0.0) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_randomMutex);
+        return std::uniform_real_distribution<double>(0.0, 1.0)(m_random) < m_options.errorRate;
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            if (m_stopping) {
+                return;
+            }
+            if (m_tasks.empty()) {
+                m_wake.wait(lock);
+                continue;
+            }
+            const auto due = m_tasks.top().due;
+            if (Clock::now() < due) {
+                m_wake.wait_until(lock, due);
+                continue;
+            }
+            Task task = m_tasks.top();
+            m_tasks.pop();
+            lock.unlock();
+            task.run();
+            lock.lock();
+        }
+    }
+
+    const MockOptions m_options;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::priority_queue<Task, std::vector<Task>, std::greater<Task>> m_tasks;
+    uint64_t m_sequence{0};
+    bool m_stopping{false};
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_eventMutex;
+    FFICallBack m_eventCallback{nullptr};
+    void* m_eventUserData{nullptr};
+
+    std::mutex m_topicsMutex;
+    std::set<std::string> m_topics;
+
+    std::mutex m_randomMutex;
+    std::mt19937_64 m_random;
+};
+
+MockNode* node(void* ctx)
+{
+    return static_cast<MockNode*>(ctx);
+}
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+extern "C" {
+
+void* logosdelivery_create_node(const char* configJson, FFICallBack callback, void* userData)
+{
+    if (!configJson) {
+        if (callback) {
+            static const char error[] = "mock: missing configuration";
+            callback(RET_ERR, error, sizeof(error) - 1, userData);
+        }
+        return nullptr;
+    }
+    return new MockNode(parseOptions(configJson));
+}
+
+int logosdelivery_destroy(void* ctx, FFICallBack callback, void* userData)
+{
+    if (!ctx) {
+        return RET_ERR;
+    }
+    delete node(ctx);
+    if (callback) {
+        callback(RET_OK, nullptr, 0, userData);
+    }
+    return RET_OK;
+}
+
+void logosdelivery_set_event_callback(void* ctx, FFICallBack callback, void* userData)
+{
+    if (ctx) {
+        node(ctx)->setEventCallback(callback, userData);
+    }
+}
+
+int logosdelivery_start_node(void* ctx, FFICallBack callback, void* userData)
+{
+    if (!ctx) {
+        return RET_ERR;
+    }
+    MockNode* mock = node(ctx);
+    return mock->respond(callback, userData, [mock](bool&) {
+        if (!mock->started.exchange(true)) {
+            mock->schedule(1, [mock] {
+                mock->emitEvent(R"({"eventType":"connection_status_change","connectionStatus":"Connected"})");
+            });
+        }
+        return std::string();
+    });
+}
+
+int logosdelivery_stop_node(void* ctx, FFICallBack callback, void* userData)
+{
+    if (!ctx) {
+        return RET_ERR;
+    }
+    MockNode* mock = node(ctx);
+    return mock->respond(callback, userData, [mock](bool&) {
+        mock->started = false;
+        return std::string();
+    });
+}
+
+int logosdelivery_subscribe(void* ctx, FFICallBack callback, void* userData, const char* contentTopic)
+{
+    if (!ctx || !contentTopic) {
+        return RET_ERR;
+    }
+    MockNode* mock = node(ctx);
+    return mock->respond(callback, userData, [mock, topic = std::string(contentTopic)](bool&) {
+        mock->setSubscribed(topic, true);
+        return std::string();
+    });
+}
+
+int logosdelivery_unsubscribe(void* ctx, FFICallBack callback, void* userData, const char* contentTopic)
+{
+    if (!ctx || !contentTopic) {
+        return RET_ERR;
+    }
+    MockNode* mock = node(ctx);
+    return mock->respond(callback, userData, [mock, topic = std::string(contentTopic)](bool&) {
+        mock->setSubscribed(topic, false);
+        return std::string();
+    });
+}
+
+int logosdelivery_send(void* ctx, FFICallBack callback, void* userData, const char* messageJson)
+{
+    if (!ctx || !messageJson) {
+        return RET_ERR;
+    }
+    MockNode* mock = node(ctx);
+    // Copy what the loop-back needs now; the caller's buffer is not ours to keep
+    const std::string rawTopic = rawStringField(messageJson, "contentTopic");
+    const std::string payload = rawStringField(messageJson, "payload");
+
+    return mock->respond(callback, userData, [mock, rawTopic, payload](bool& ok) {
+        if (!mock->started.load()) {
+            ok = false;
+            return std::string("mock: node not started");
+        }
+        if (rawTopic.empty()) {
+            ok = false;
+            return std::string("mock: missing contentTopic");
+        }
+
+        const uint64_t sequence = mock->nextRequest.fetch_add(1);
+        const std::string requestId = hex(sequence, 16);
+        const std::string messageHash =
+            "0x" + hex(std::hash<std::string>{}(payload) ^ sequence, 16) + hex(sequence, 48);
+
+        mock->schedule(1, [mock, requestId, messageHash] {
+            mock->emitEvent(R"({"eventType":"message_propagated","requestId":")" + requestId
+                + R"(","messageHash":")" + messageHash + "\"}");
+        });
+        mock->schedule(2, [mock, requestId, messageHash] {
+            mock->emitEvent(R"({"eventType":"message_sent","requestId":")" + requestId
+                + R"(","messageHash":")" + messageHash + "\"}");
+        });
+        if (mock->isSubscribed(unescapeSimple(rawTopic))) {
+            mock->schedule(2, [mock, messageHash, rawTopic, payload] {
+                mock->emitEvent(R"({"eventType":"message_received","messageHash":")" + messageHash
+                    + R"(","message":{"payload":")" + payload
+                    + R"(","contentTopic":")" + rawTopic
+                    + R"(","meta":"","version":0,"timestamp":)" + std::to_string(nowNs())
+                    + R"(,"ephemeral":false}})");
+            });
+        }
+        return requestId;
+    });
+}
+
+int logosdelivery_get_available_node_info_ids(void* ctx, FFICallBack callback, void* userData)
+{
+    if (!ctx) {
+        return RET_ERR;
+    }
+    return node(ctx)->respond(callback, userData, [](bool&) { return std::string("@[Version]"); });
+}
+
+int logosdelivery_get_node_info(void* ctx, FFICallBack callback, void* userData, const char* nodeInfoId)
+{
+    if (!ctx || !nodeInfoId) {
+        return RET_ERR;
+    }
+    return node(ctx)->respond(callback, userData, [id = std::string(nodeInfoId)](bool& ok) {
+        if (id == "Version") {
+            return std::string("mock-1.0.0");
+        }
+        ok = false;
+        return "mock: unknown node info id " + escapeSimple(id.c_str());
+    });
+}
+
+int logosdelivery_get_available_configs(void* ctx, FFICallBack callback, void* userData)
+{
+    if (!ctx) {
+        return RET_ERR;
+    }
+    return node(ctx)->respond(callback, userData, [](bool&) {
+        return std::string(R"({"mockLatencyUs":"int","mockJitterUs":"int","mockErrorRate":"float","mockCallbackThreads":"int"})");
+    });
+}
+
+int logosdelivery_mock_inject_event(void* ctx, const char* eventJson, size_t len)
+{
+    if (!ctx || !eventJson) {
+        return RET_ERR;
+    }
+    return node(ctx)->emitEvent(std::string(eventJson, len)) ? RET_OK : RET_ERR;
+}
+
+} // extern "C"
@@ -0,0 +1,215 @@
+#include "module_options.h"
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <algorithm>
+#include "delivery_log.h"
+
+namespace {
+constexpr char MODULE_OPTIONS_KEY[] = "deliveryModule";
+constexpr uint32_t MAX_NODE_POOL_SIZE = 64;
+constexpr uint32_t MIN_REASSEMBLY_TIMEOUT_MS = 1000;
+
+// Compact JSON text of a single option value for log fields
+QString jsonText(const QJsonValue& value)
+{
+    const QByteArray array = QJsonDocument(QJsonArray{value}).toJson(QJsonDocument::Compact);
+    return QString::fromUtf8(array.mid(1, array.size() - 2));
+}
+
+void readLimit(const QJsonObject& json, const QString& key, uint32_t& limit)
+{
+    const QJsonValue value = json.value(key);
+    if (value.isUndefined()) {
+        return;
+    }
+    const double number = value.toDouble(-1);
+    if (!value.isDouble() || number < 0 || number > UINT32_MAX || number != static_cast<uint32_t>(number)) {
+        DELIVERY_LOG_WARNING("moduleOptions", .field("option", key).field("value", jsonText(value)).message("ignoring invalid value"));
+        return;
+    }
+    limit = static_cast<uint32_t>(number);
+}
+
+// Parses a liblogosdelivery size such as `"150KiB"`, `"1MB"` or `"4096"`.
+bool parseByteSize(const QJsonValue& value, uint32_t& bytes)
+{
+    if (value.isDouble()) {
+        const double number = value.toDouble();
+        if (number <= 0 || number > UINT32_MAX) {
+            return false;
+        }
+        bytes = static_cast<uint32_t>(number);
+        return true;
+    }
+    const QString text = value.toString().trimmed();
+    qsizetype digits = 0;
+    while (digits < text.size() && text.at(digits).isDigit()) {
+        ++digits;
+    }
+    bool ok = false;
+    const qulonglong number = text.left(digits).toULongLong(&ok);
+    if (!ok) {
+        return false;
+    }
+    static const QHash<QString, qulonglong> units{
+        {"", 1}, {"b", 1},
+        {"kb", 1000}, {"kib", 1024},
+        {"mb", 1000 * 1000}, {"mib", 1024 * 1024},
+    };
+    const auto unit = units.constFind(text.mid(digits).trimmed().toLower());
+    if (unit == units.constEnd() || number == 0 || number > UINT32_MAX / *unit) {
+        return false;
+    }
+    bytes = static_cast<uint32_t>(number * *unit);
+    return true;
+}
+} // namespace
+
+DeliveryModuleOptions DeliveryModuleOptions::fromJson(const QJsonObject& json)
+{
+    DeliveryModuleOptions options;
+
+    const QString payloadFormat = json.value("receivedPayloadFormat").toString();
+    if (payloadFormat == "bytes") {
+        options.receivedPayloadFormat = ReceivedPayloadFormat::Bytes;
+    } else if (payloadFormat == "both") {
+        options.receivedPayloadFormat = ReceivedPayloadFormat::Both;
+    } else if (!payloadFormat.isEmpty() && payloadFormat != "base64") {
+        DELIVERY_LOG_WARNING("moduleOptions", .field("option", QStringLiteral("receivedPayloadFormat")).field("value", payloadFormat)
+            .message("unknown value"));
+    }
+
+    readLimit(json, "maxInflightSends", options.maxInflightSends);
+    readLimit(json, "maxInflightSendsPerTopic", options.maxInflightSendsPerTopic);
+    readLimit(json, "dedupWindowMs", options.dedupWindowMs);
+    readLimit(json, "dedupCapacity", options.dedupCapacity);
+    readLimit(json, "nodeInfoCacheTtlMs", options.nodeInfoCacheTtlMs);
+    readLimit(json, "staticNodeInfoCacheTtlMs", options.staticNodeInfoCacheTtlMs);
+
+    readLimit(json, "nodePoolSize", options.nodePoolSize);
+    const uint32_t poolSize = std::clamp<uint32_t>(options.nodePoolSize, 1, MAX_NODE_POOL_SIZE);
+    if (poolSize != options.nodePoolSize) {
+        DELIVERY_LOG_WARNING("moduleOptions", .field("option", QStringLiteral("nodePoolSize")).field("using", static_cast<qint64>(poolSize))
+            .message(QStringLiteral("must be between 1 and %1").arg(MAX_NODE_POOL_SIZE)));
+        options.nodePoolSize = poolSize;
+    }
+
+    const QString poolRouting = json.value("nodePoolRouting").toString();
+    if (poolRouting == "autoshard") {
+        options.nodePoolRouting = NodePoolRouting::Autoshard;
+    } else if (!poolRouting.isEmpty() && poolRouting != "contentTopic") {
+        DELIVERY_LOG_WARNING("moduleOptions", .field("option", QStringLiteral("nodePoolRouting")).field("value", poolRouting)
+            .message("unknown value"));
+    }
+
+    options.journalDir = json.value("journalDir").toString();
+    readLimit(json, "journalSegmentBytes", options.journalSegmentBytes);
+    readLimit(json, "journalSyncIntervalMs", options.journalSyncIntervalMs);
+    const QString journalSync = json.value("journalSync").toString();
+    if (journalSync == "none") {
+        options.journalSync = JournalSync::None;
+    } else if (journalSync == "always") {
+        options.journalSync = JournalSync::Always;
+    } else if (!journalSync.isEmpty() && journalSync != "interval") {
+        DELIVERY_LOG_WARNING("moduleOptions", .field("option", QStringLiteral("journalSync")).field("value", journalSync)
+            .message("unknown value"));
+    }
+
+    options.receivedStorePath = json.value("receivedStorePath").toString();
+    readLimit(json, "receivedStoreBytes", options.receivedStoreBytes);
+    readLimit(json, "receivedStoreMaxAgeMs", options.receivedStoreMaxAgeMs);
+
+    const QJsonValue compressTopics = json.value("compressTopics");
+    if (compressTopics.isArray()) {
+        for (const QJsonValue& topic : compressTopics.toArray()) {
+            if (topic.isString() && !topic.toString().isEmpty()) {
+                options.compressTopics << topic.toString();
+            } else {
+                DELIVERY_LOG_WARNING("moduleOptions", .field("option", QStringLiteral("compressTopics")).field("value", jsonText(topic))
+                    .message("ignoring invalid entry"));
+            }
+        }
+    } else if (!compressTopics.isUndefined()) {
+        DELIVERY_LOG_WARNING("moduleOptions", .field("option", QStringLiteral("compressTopics")).message("ignoring non-array value"));
+    }
+    readLimit(json, "compressionLevel", options.compressionLevel);
+    const uint32_t compressionLevel = std::clamp<uint32_t>(options.compressionLevel, 1, 9);
+    if (compressionLevel != options.compressionLevel) {
+        DELIVERY_LOG_WARNING("moduleOptions", .field("option", QStringLiteral("compressionLevel"))
+            .field("using", static_cast<qint64>(compressionLevel)).message("must be between 1 and 9"));
+        options.compressionLevel = compressionLevel;
+    }
+    readLimit(json, "compressMinBytes", options.compressMinBytes);
+
+    readLimit(json, "maxTransferBytes", options.maxTransferBytes);
+    readLimit(json, "reassemblyMaxBytes", options.reassemblyMaxBytes);
+    readLimit(json, "reassemblyTimeoutMs", options.reassemblyTimeoutMs);
+    if (options.reassemblyTimeoutMs < MIN_REASSEMBLY_TIMEOUT_MS) {
+        DELIVERY_LOG_WARNING("moduleOptions", .field("option", QStringLiteral("reassemblyTimeoutMs"))
+            .field("using", static_cast<qint64>(MIN_REASSEMBLY_TIMEOUT_MS)).message("below the minimum"));
+        options.reassemblyTimeoutMs = MIN_REASSEMBLY_TIMEOUT_MS;
+    }
+
+    const QJsonValue callTimeouts = json.value("callTimeoutsMs");
+    if (callTimeouts.isObject()) {
+        const QJsonObject timeouts = callTimeouts.toObject();
+        uint32_t defaultTimeout = 0;
+        readLimit(timeouts, "default", defaultTimeout);
+        options.callTimeoutMs.fill(defaultTimeout);
+        for (auto it = timeouts.begin(); it != timeouts.end(); ++it) {
+            if (it.key() == "default") {
+                continue;
+            }
+            size_t op = 0;
+            while (op < options.callTimeoutMs.size() && ffiOperationName(static_cast<FfiOperation>(op)) != it.key()) {
+                ++op;
+            }
+            if (op == options.callTimeoutMs.size()) {
+                DELIVERY_LOG_WARNING("moduleOptions", .field("option", QStringLiteral("callTimeoutsMs")).field("operation", it.key())
+                    .message("unknown operation"));
+                continue;
+            }
+            readLimit(timeouts, it.key(), options.callTimeoutMs[op]);
+        }
+    } else if (!callTimeouts.isUndefined()) {
+        DELIVERY_LOG_WARNING("moduleOptions", .field("option", QStringLiteral("callTimeoutsMs")).message("ignoring non-object value"));
+    }
+
+    return options;
+}
+
+QByteArray DeliveryModuleOptions::extract(const QString& cfg, DeliveryModuleOptions& options)
+{
+    options = DeliveryModuleOptions{};
+
+    QByteArray cfgUtf8 = cfg.toUtf8();
+    QJsonDocument doc = QJsonDocument::fromJson(cfgUtf8);
+    if (!doc.isObject()) {
+        return cfgUtf8;
+    }
+
+    QJsonObject nodeCfg = doc.object();
+    const bool hasModuleOptions = nodeCfg.contains(MODULE_OPTIONS_KEY);
+    if (hasModuleOptions) {
+        const QJsonValue moduleCfg = nodeCfg.take(MODULE_OPTIONS_KEY);
+        if (moduleCfg.isObject()) {
+            options = fromJson(moduleCfg.toObject());
+        } else {
+            DELIVERY_LOG_WARNING("moduleOptions", .field("option", QString::fromLatin1(MODULE_OPTIONS_KEY)).message("ignoring non-object value"));
+        }
+    }
+
+    // Chunking needs the node's own message limit
+    const QJsonValue maxMessageSize = nodeCfg.value("maxMessageSize");
+    if (!maxMessageSize.isUndefined() && !parseByteSize(maxMessageSize, options.maxMessageBytes)) {
+        DELIVERY_LOG_WARNING("moduleOptions", .field("option", QStringLiteral("maxMessageSize")).field("value", jsonText(maxMessageSize))
+            .message("cannot read value"));
+    }
+    if (!hasModuleOptions) {
+        return cfgUtf8;
+    }
+
+    return QJsonDocument(nodeCfg).toJson(QJsonDocument::Compact);
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <array>
+#include <cstdint>
+#include "delivery_metrics.h"
+
+/**
+ * @brief Module-side settings carried in the `createNode` configuration.
+ *
+ * They live under the `deliveryModule` key of the configuration document,
+ * which is removed before the document is handed to liblogosdelivery:
+ * @code{.json}
+ * {
+ *   "mode": "Core",
+ *   "preset": "logos.dev",
+ *   "deliveryModule": { "receivedPayloadFormat": "bytes" }
+ * }
+ * @endcode
+ * Missing keys keep their defaults; malformed values are ignored with a warning.
+ */
+struct DeliveryModuleOptions {
+    /**
+     * @brief How received payloads are surfaced (`receivedPayloadFormat`).
+     */
+    enum class ReceivedPayloadFormat {
+        Base64, ///< `"base64"` (default): `messageReceived` with the wire base64 string
+        Bytes,  ///< `"bytes"`: `messageReceivedBytes` with decoded bytes only
+        Both,   ///< `"both"`: both events for every message
+    };
+
+    ReceivedPayloadFormat receivedPayloadFormat{ReceivedPayloadFormat::Base64};
+
+    /**
+     * @brief Most sends awaiting their delivery outcome on this node (`maxInflightSends`); `0` is unlimited.
+     */
+    uint32_t maxInflightSends{0};
+
+    /**
+     * @brief Most sends awaiting their delivery outcome per content topic
+     * (`maxInflightSendsPerTopic`); `0` is unlimited.
+     */
+    uint32_t maxInflightSendsPerTopic{0};
+
+    /**
+     * @brief Window in which a repeated `messageHash` is dropped before emission
+     * (`dedupWindowMs`); `0` disables deduplication.
+     */
+    uint32_t dedupWindowMs{0};
+
+    /**
+     * @brief Received messages remembered exactly for deduplication (`dedupCapacity`).
+     */
+    uint32_t dedupCapacity{8192};
+
+    /**
+     * @brief How long node info that may change while the node runs is cached
+     * (`nodeInfoCacheTtlMs`); `0` disables caching it.
+     */
+    uint32_t nodeInfoCacheTtlMs{1000};
+
+    /**
+     * @brief How long node info fixed for a context (version, available node
+     * info ids and configs) is cached (`staticNodeInfoCacheTtlMs`); `0` disables caching it.
+     */
+    uint32_t staticNodeInfoCacheTtlMs{3600000};
+
+    /**
+     * @brief Callback timeout per FFI operation (`callTimeoutsMs`, keyed by
+     * operation name such as `send` or `start`, plus `default`); `0` keeps the
+     * built-in 30 s.
+     */
+    std::array<uint32_t, static_cast<size_t>(FfiOperation::Count)> callTimeoutMs{};
+
+    /**
+     * @brief liblogosdelivery contexts created by `createNode` (`nodePoolSize`),
+     * between 1 and 64.
+     */
+    uint32_t nodePoolSize{1};
+
+    /**
+     * @brief How content topics are spread over the node pool (`nodePoolRouting`).
+     */
+    enum class NodePoolRouting {
+        ContentTopic, ///< `"contentTopic"` (default): hash of the whole content topic
+        Autoshard,    ///< `"autoshard"`: hash of `/{application}/{version}`
+    };
+
+    NodePoolRouting nodePoolRouting{NodePoolRouting::ContentTopic};
+
+    /**
+     * @brief Directory of the outbound journal (`journalDir`); empty disables it.
+     */
+    QString journalDir;
+
+    /**
+     * @brief Size of each journal segment file (`journalSegmentBytes`), at least 64 KiB.
+     */
+    uint32_t journalSegmentBytes{8u << 20};
+
+    /**
+     * @brief When journal writes are flushed to disk (`journalSync`).
+     */
+    enum class JournalSync {
+        None,     ///< `"none"`: left to the OS
+        Interval, ///< `"interval"` (default): every `journalSyncIntervalMs`
+        Always,   ///< `"always"`: before every send
+    };
+
+    JournalSync journalSync{JournalSync::Interval};
+
+    /**
+     * @brief Flush period of the `"interval"` journal sync policy (`journalSyncIntervalMs`).
+     */
+    uint32_t journalSyncIntervalMs{100};
+
+    /**
+     * @brief File of the received message store (`receivedStorePath`); empty disables it.
+     */
+    QString receivedStorePath;
+
+    /**
+     * @brief Ring size of the received message store (`receivedStoreBytes`), at least 1 MiB.
+     */
+    uint32_t receivedStoreBytes{64u << 20};
+
+    /**
+     * @brief Age after which stored messages are dropped (`receivedStoreMaxAgeMs`);
+     * `0` keeps them until their space is needed.
+     */
+    uint32_t receivedStoreMaxAgeMs{0};
+
+    /**
+     * @brief Content topics whose sent payloads are compressed (`compressTopics`);
+     * an entry ending in `*` matches every topic with that prefix.
+     */
+    QStringList compressTopics;
+
+    /**
+     * @brief zlib level of payload compression (`compressionLevel`), 1 (fastest) to 9.
+     */
+    uint32_t compressionLevel{1};
+
+    /**
+     * @brief Smallest payload that is compressed (`compressMinBytes`).
+     */
+    uint32_t compressMinBytes{256};
+
+    /**
+     * @brief Largest payload `send` accepts, splitting what exceeds one message
+     * into chunks (`maxTransferBytes`); `0` disables chunking.
+     */
+    uint32_t maxTransferBytes{0};
+
+    /**
+     * @brief Memory for incoming chunked transfers not yet complete (`reassemblyMaxBytes`);
+     * `0` disables reassembly.
+     */
+    uint32_t reassemblyMaxBytes{64u << 20};
+
+    /**
+     * @brief Time without a new chunk after which a partial transfer is discarded
+     * (`reassemblyTimeoutMs`), at least 1 s.
+     */
+    uint32_t reassemblyTimeoutMs{60000};
+
+    /**
+     * @brief `maxMessageSize` of the node configuration in bytes; read by
+     * @ref extract from outside the `deliveryModule` object.
+     */
+    uint32_t maxMessageBytes{150u << 10};
+
+    /**
+     * @brief Reads options from the `deliveryModule` object.
+     */
+    static DeliveryModuleOptions fromJson(const QJsonObject& json);
+
+    /**
+     * @brief Splits a `createNode` configuration into module options and node config.
+     *
+     * @param cfg Full configuration document as passed to `createNode`.
+     * @param options Receives the parsed module options (defaults when absent).
+     * @return UTF-8 configuration for liblogosdelivery without the `deliveryModule`
+     *         key. A document that is not a JSON object is returned unchanged so
+     *         liblogosdelivery can report the error itself.
+     */
+    static QByteArray extract(const QString& cfg, DeliveryModuleOptions& options);
+};
@@ -0,0 +1,84 @@
+#include "node_info_cache.h"
+
+#include <iterator>
+
+void NodeInfoCache::setTtl(Lifetime lifetime, Clock::duration ttl)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ttl[static_cast<size_t>(lifetime)] = ttl;
+}
+
+QExpected<QString> NodeInfoCache::get(const QString& key, Lifetime lifetime, const Fetch& fetch)
+{
+    const size_t kind = static_cast<size_t>(lifetime);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const Clock::duration ttl = m_ttl[kind];
+    if (ttl <= Clock::duration::zero()) {
+        ++m_counters.misses;
+        lock.unlock();
+        return fetch();
+    }
+
+    const auto entry = m_entries.constFind(key);
+    if (entry != m_entries.constEnd() && Clock::now() < entry->expiresAt) {
+        ++m_counters.hits;
+        return QExpected<QString>::ok(entry->value);
+    }
+
+    const auto flight = m_flights.constFind(key);
+    if (flight != m_flights.constEnd()) {
+        ++m_counters.coalesced;
+        std::shared_future<QExpected<QString>> result = *flight;
+        lock.unlock();
+        return result.get();
+    }
+
+    ++m_counters.misses;
+    std::promise<QExpected<QString>> promise;
+    m_flights.insert(key, promise.get_future().share());
+    const uint64_t generation = m_generation[kind];
+    lock.unlock();
+
+    const QExpected<QString> result = fetch();
+
+    lock.lock();
+    m_flights.remove(key);
+    if (result.isOk() && generation == m_generation[kind]) {
+        m_entries.insert(key, Entry{result.value(), Clock::now() + ttl, lifetime});
+    }
+    lock.unlock();
+
+    promise.set_value(result);
+    return result;
+}
+
+void NodeInfoCache::invalidateLocked(Lifetime lifetime)
+{
+    ++m_generation[static_cast<size_t>(lifetime)];
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        it = it->lifetime == lifetime ? m_entries.erase(it) : std::next(it);
+    }
+}
+
+void NodeInfoCache::invalidate(Lifetime lifetime)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_counters.invalidations;
+    invalidateLocked(lifetime);
+}
+
+void NodeInfoCache::invalidateAll()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_counters.invalidations;
+    invalidateLocked(Lifetime::Static);
+    invalidateLocked(Lifetime::Volatile);
+}
+
+NodeInfoCache::Stats NodeInfoCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats snapshot = m_counters;
+    snapshot.entries = static_cast<size_t>(m_entries.size());
+    return snapshot;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include "QExpected.h"
+
+/**
+ * @brief TTL cache for node info queries answered by liblogosdelivery.
+ *
+ * Entries are either static (fixed for the lifetime of a context, such as the
+ * version or the config schema) or volatile (may change while the node runs).
+ * Each kind has its own TTL and is invalidated separately, so the plugin can
+ * drop volatile entries on connection changes and everything on `createNode`.
+ *
+ * Concurrent misses for the same key are coalesced: the first caller runs the
+ * fetch and the others wait for its result instead of issuing their own FFI
+ * calls. Errors are returned to every waiter but never cached, and a result
+ * fetched across an invalidation is not stored.
+ */
+class NodeInfoCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Fetch = std::function<QExpected<QString>()>;
+
+    enum class Lifetime : uint8_t { Static, Volatile };
+
+    struct Stats {
+        size_t entries{0};
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t coalesced{0};
+        uint64_t invalidations{0};
+    };
+
+    /**
+     * @brief TTL of entries of @p lifetime; zero disables caching them.
+     */
+    void setTtl(Lifetime lifetime, Clock::duration ttl);
+
+    /**
+     * @brief Cached value of @p key, or the result of @p fetch on a miss.
+     */
+    QExpected<QString> get(const QString& key, Lifetime lifetime, const Fetch& fetch);
+
+    /**
+     * @brief Drops all entries of @p lifetime.
+     */
+    void invalidate(Lifetime lifetime);
+
+    /**
+     * @brief Drops every entry.
+     */
+    void invalidateAll();
+
+    Stats stats() const;
+
+private:
+    static constexpr size_t kLifetimes = 2;
+
+    struct Entry {
+        QString value;
+        Clock::time_point expiresAt;
+        Lifetime lifetime;
+    };
+
+    void invalidateLocked(Lifetime lifetime);
+
+    mutable std::mutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    QHash<QString, std::shared_future<QExpected<QString>>> m_flights;
+    std::array<Clock::duration, kLifetimes> m_ttl{};
+    std::array<uint64_t, kLifetimes> m_generation{};
+    Stats m_counters;
+};
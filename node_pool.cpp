@@ -0,0 +1,115 @@
+#include "node_pool.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+namespace {
+uint64_t stableHash(std::string_view key)
+{
+    // FNV-1a with a finalizer; stable across processes and builds
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : key) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
+} // namespace
+
+void NodePool::assign(const std::vector<void*>& contexts, Routing routing)
+{
+    const size_t count = std::min(contexts.size(), kMaxContexts);
+    // Shrink first so readers never index a slot that is being rewritten
+    m_size.store(0, std::memory_order_release);
+    m_routing.store(routing, std::memory_order_relaxed);
+    for (size_t i = 0; i < kMaxContexts; ++i) {
+        m_contexts[i].store(i < count ? contexts[i] : nullptr, std::memory_order_relaxed);
+    }
+    m_size.store(count, std::memory_order_release);
+}
+
+std::vector<void*> NodePool::release()
+{
+    std::vector<void*> released = contexts();
+    m_size.store(0, std::memory_order_release);
+    for (auto& context : m_contexts) {
+        context.store(nullptr, std::memory_order_relaxed);
+    }
+    return released;
+}
+
+void* NodePool::at(size_t index) const
+{
+    return index < size() ? m_contexts[index].load(std::memory_order_relaxed) : nullptr;
+}
+
+std::vector<void*> NodePool::contexts() const
+{
+    const size_t count = size();
+    std::vector<void*> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(m_contexts[i].load(std::memory_order_relaxed));
+    }
+    return result;
+}
+
+size_t NodePool::indexFor(std::string_view contentTopic) const
+{
+    const size_t count = size();
+    if (count <= 1) {
+        return 0;
+    }
+    const Routing routing = m_routing.load(std::memory_order_relaxed);
+    return static_cast<size_t>(stableHash(routingKey(contentTopic, routing)) % count);
+}
+
+void* NodePool::forTopic(std::string_view contentTopic) const
+{
+    return at(indexFor(contentTopic));
+}
+
+std::string_view NodePool::routingKey(std::string_view contentTopic, Routing routing)
+{
+    if (routing != Routing::Autoshard) {
+        return contentTopic;
+    }
+
+    // `/{application}/{version}/{name}/{encoding}`, optionally prefixed by `/{generation}`
+    std::array<size_t, 6> slashes{};
+    size_t count = 0;
+    for (size_t i = 0; i < contentTopic.size() && count < slashes.size(); ++i) {
+        if (contentTopic[i] == '/') {
+            slashes[count++] = i;
+        }
+    }
+    if (count == 4 && slashes[0] == 0) {
+        return contentTopic.substr(0, slashes[2]);
+    }
+    if (count == 5 && slashes[0] == 0) {
+        return contentTopic.substr(slashes[1], slashes[3] - slashes[1]);
+    }
+    // Not a structured topic; fall back to the whole string
+    return contentTopic;
+}
+
+QByteArray NodePool::memberConfig(const QByteArray& config, size_t index)
+{
+    if (index == 0) {
+        return config;
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(config);
+    if (!doc.isObject()) {
+        return config;
+    }
+
+    // WakuNodeConf adds portsShift to every port, including the ones left at their defaults
+    QJsonObject memberCfg = doc.object();
+    memberCfg["portsShift"] = memberCfg.value("portsShift").toInt() + static_cast<int>(index);
+    // A node key is an identity; members sharing it would collide on the network
+    memberCfg.remove("nodekey");
+    return QJsonDocument(memberCfg).toJson(QJsonDocument::Compact);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief liblogosdelivery contexts that share the plugin's traffic.
+ *
+ * Each context is a full node with its own event thread. Content topics are
+ * assigned to contexts by a stable hash, so every send and subscription for a
+ * topic lands on the same node and ordering per topic is kept. With
+ * `Autoshard` routing only the application and version segments are hashed,
+ * so all topics that autosharding puts on one pubsub shard share a node.
+ *
+ * The context list is published through atomics and may be read from any
+ * thread while @ref assign replaces it.
+ */
+class NodePool {
+public:
+    static constexpr size_t kMaxContexts = 64;
+
+    enum class Routing : uint8_t {
+        ContentTopic, ///< Hash of the whole content topic.
+        Autoshard,    ///< Hash of `/{application}/{version}`, as used for autosharding.
+    };
+
+    /**
+     * @brief Replaces the pool; at most @ref kMaxContexts contexts are kept.
+     */
+    void assign(const std::vector<void*>& contexts, Routing routing);
+
+    /**
+     * @brief Empties the pool and returns the contexts it held.
+     */
+    std::vector<void*> release();
+
+    size_t size() const { return m_size.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+    Routing routing() const { return m_routing.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Context answering node-wide queries; `nullptr` when empty.
+     */
+    void* primary() const { return at(0); }
+
+    void* at(size_t index) const;
+
+    /**
+     * @brief All contexts, primary first.
+     */
+    std::vector<void*> contexts() const;
+
+    /**
+     * @brief Index of the context serving @p contentTopic.
+     */
+    size_t indexFor(std::string_view contentTopic) const;
+
+    /**
+     * @brief Context serving @p contentTopic; `nullptr` when empty.
+     */
+    void* forTopic(std::string_view contentTopic) const;
+
+    /**
+     * @brief Part of @p contentTopic that is hashed under @p routing.
+     */
+    static std::string_view routingKey(std::string_view contentTopic, Routing routing);
+
+    /**
+     * @brief Configuration for the context at @p index derived from @p config.
+     *
+     * The primary uses @p config unchanged. Every other member adds its index
+     * to `portsShift`, which shifts all of its ports, configured or default, so
+     * the nodes can listen side by side, and drops `nodekey` so that each
+     * member gets an identity of its own.
+     */
+    static QByteArray memberConfig(const QByteArray& config, size_t index);
+
+private:
+    std::array<std::atomic<void*>, kMaxContexts> m_contexts{};
+    std::atomic<size_t> m_size{0};
+    std::atomic<Routing> m_routing{Routing::ContentTopic};
+};
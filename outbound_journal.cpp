@@ -0,0 +1,481 @@
+#include "outbound_journal.h"
+
+#include <QDir>
+#include <algorithm>
+#include <cstring>
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "delivery_log.h"
+
+namespace {
+constexpr uint32_t RECORD_MAGIC = 0x314a4c44; // "DLJ1"
+constexpr uint8_t RECORD_APPEND = 1;
+constexpr uint8_t RECORD_RETIRE = 2;
+constexpr uint8_t FLAG_EPHEMERAL = 1u << 0;
+constexpr uint32_t MIN_SEGMENT_BYTES = 64u << 10;
+
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t bodyLength;
+    uint64_t id;
+    uint32_t checksum;
+    uint16_t topicLength;
+    uint8_t type;
+    uint8_t flags;
+};
+static_assert(sizeof(RecordHeader) == 24, "journal record header must stay 24 bytes");
+
+constexpr qint64 recordBytes(qint64 bodyLength)
+{
+    return (static_cast<qint64>(sizeof(RecordHeader)) + bodyLength + 7) & ~qint64(7);
+}
+
+uint32_t checksumOf(const RecordHeader& header, const uchar* body)
+{
+    // FNV-1a over the identifying header fields and the body
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](const void* data, size_t length) {
+        const auto* bytes = static_cast<const uchar*>(data);
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+    };
+    mix(&header.id, sizeof(header.id));
+    mix(&header.topicLength, sizeof(header.topicLength));
+    mix(&header.type, sizeof(header.type));
+    mix(&header.flags, sizeof(header.flags));
+    mix(body, header.bodyLength);
+    return hash;
+}
+
+QString segmentName(uint64_t sequence)
+{
+    return QStringLiteral("outbound-%1.wal").arg(sequence, 16, 10, QLatin1Char('0'));
+}
+
+void flushMapping(uchar* base, qint64 from, qint64 to)
+{
+#ifdef Q_OS_UNIX
+    static const qint64 pageSize = sysconf(_SC_PAGESIZE);
+    const qint64 start = from & ~(pageSize - 1);
+    if (to > start) {
+        msync(base + start, static_cast<size_t>(to - start), MS_SYNC);
+    }
+#else
+    Q_UNUSED(base);
+    Q_UNUSED(from);
+    Q_UNUSED(to);
+#endif
+}
+} // namespace
+
+struct OutboundJournal::Segment {
+    uint64_t sequence{0};
+    QFile file;
+    uchar* data{nullptr};
+    qint64 size{0};
+    qint64 used{0};
+    size_t live{0};
+
+    ~Segment()
+    {
+        if (data) {
+            file.unmap(data);
+        }
+    }
+};
+
+OutboundJournal::~OutboundJournal()
+{
+    close();
+}
+
+QExpected<void> OutboundJournal::open(const Config& config)
+{
+    close();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+    m_config.segmentBytes = std::max(config.segmentBytes, MIN_SEGMENT_BYTES);
+    m_counters = Stats{};
+
+    auto fail = [this](const QString& error) {
+        m_active.reset();
+        m_segments.clear();
+        m_entries.clear();
+        return QExpected<void>::err(error);
+    };
+
+    QDir dir(m_config.directory);
+    if (!dir.mkpath(".")) {
+        return fail(QStringLiteral("journal: cannot create directory %1").arg(m_config.directory));
+    }
+
+    const QStringList names = dir.entryList({QStringLiteral("outbound-*.wal")}, QDir::Files, QDir::Name);
+    for (const QString& name : names) {
+        bool ok = false;
+        const uint64_t sequence = name.mid(9, 16).toULongLong(&ok);
+        if (!ok) {
+            continue;
+        }
+        auto segment = std::make_shared<Segment>();
+        segment->sequence = sequence;
+        segment->file.setFileName(dir.filePath(name));
+        if (!segment->file.open(QIODevice::ReadWrite)) {
+            return fail(QStringLiteral("journal: cannot open %1: %2")
+                .arg(segment->file.fileName(), segment->file.errorString()));
+        }
+        segment->size = segment->file.size();
+        segment->data = segment->size > 0 ? segment->file.map(0, segment->size) : nullptr;
+        if (segment->size > 0 && !segment->data) {
+            return fail(QStringLiteral("journal: cannot map %1").arg(segment->file.fileName()));
+        }
+        m_segments.emplace(sequence, segment);
+        recoverSegment(*segment);
+    }
+    m_counters.recovered = static_cast<uint64_t>(m_entries.size());
+    collectGarbage();
+
+    // New records always go to a fresh segment; recovered ones are never appended to
+    if (!rotate()) {
+        return fail(QStringLiteral("journal: cannot create a segment in %1").arg(m_config.directory));
+    }
+
+    m_enabled.store(true, std::memory_order_release);
+    if (m_config.sync == SyncPolicy::Interval) {
+        m_stopFlusher = false;
+        m_flusher = std::thread(&OutboundJournal::runFlusher, this);
+    }
+    return QExpected<void>::ok();
+}
+
+void OutboundJournal::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_enabled.store(false, std::memory_order_release);
+        m_stopFlusher = true;
+    }
+    m_flusherWake.notify_all();
+    if (m_flusher.joinable()) {
+        m_flusher.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_active && m_config.sync != SyncPolicy::None) {
+        syncActive();
+    }
+    m_active.reset();
+    m_segments.clear();
+    m_entries.clear();
+    m_byRequest.clear();
+    m_earlyRetired.clear();
+    m_submitting = 0;
+}
+
+void OutboundJournal::recoverSegment(Segment& segment)
+{
+    qint64 offset = 0;
+    while (offset + static_cast<qint64>(sizeof(RecordHeader)) <= segment.size) {
+        RecordHeader header;
+        std::memcpy(&header, segment.data + offset, sizeof(header));
+        const qint64 bodyOffset = offset + static_cast<qint64>(sizeof(header));
+        if (header.magic != RECORD_MAGIC || header.bodyLength > segment.size - bodyOffset
+            || header.topicLength > header.bodyLength
+            || checksumOf(header, segment.data + bodyOffset) != header.checksum) {
+            break;
+        }
+
+        if (header.type == RECORD_APPEND) {
+            m_entries.insert(header.id, Entry{segment.sequence, offset, {}, State::Replayable});
+            ++segment.live;
+        } else if (header.type == RECORD_RETIRE) {
+            const auto entry = m_entries.constFind(header.id);
+            if (entry != m_entries.constEnd()) {
+                const auto owner = m_segments.find(entry->segment);
+                if (owner != m_segments.end() && owner->second->live > 0) {
+                    --owner->second->live;
+                }
+                m_entries.erase(entry);
+            }
+        }
+        m_nextId = std::max(m_nextId, header.id + 1);
+        offset += recordBytes(header.bodyLength);
+    }
+    // A torn record ends the segment; nothing after it is trusted
+    segment.used = offset;
+}
+
+bool OutboundJournal::rotate()
+{
+    if (m_active && m_config.sync != SyncPolicy::None) {
+        syncActive();
+    }
+
+    const uint64_t sequence = m_segments.empty() ? 1 : m_segments.rbegin()->first + 1;
+    auto segment = std::make_shared<Segment>();
+    segment->sequence = sequence;
+    segment->size = m_config.segmentBytes;
+    segment->file.setFileName(QDir(m_config.directory).filePath(segmentName(sequence)));
+    if (!segment->file.open(QIODevice::ReadWrite | QIODevice::Truncate) || !segment->file.resize(segment->size)) {
+        DELIVERY_LOG_WARNING("journal", .field("segment", segment->file.fileName())
+            .message("cannot create segment: " + segment->file.errorString()));
+        return false;
+    }
+    segment->data = segment->file.map(0, segment->size);
+    if (!segment->data) {
+        DELIVERY_LOG_WARNING("journal", .field("segment", segment->file.fileName())
+            .message("cannot map segment: " + segment->file.errorString()));
+        segment->file.remove();
+        return false;
+    }
+
+    m_segments.emplace(sequence, segment);
+    m_active = std::move(segment);
+    m_syncedTo = 0;
+    collectGarbage();
+    return true;
+}
+
+qint64 OutboundJournal::write(uint8_t type, uint8_t flags, uint64_t id, std::string_view topic, std::string_view payload)
+{
+    const qint64 bodyLength = static_cast<qint64>(topic.size() + payload.size());
+    const qint64 bytes = recordBytes(bodyLength);
+    if (m_active->used + bytes > m_active->size && !rotate()) {
+        return -1;
+    }
+
+    Segment& segment = *m_active;
+    const qint64 offset = segment.used;
+    uchar* body = segment.data + offset + sizeof(RecordHeader);
+    if (!topic.empty()) {
+        std::memcpy(body, topic.data(), topic.size());
+    }
+    if (!payload.empty()) {
+        std::memcpy(body + topic.size(), payload.data(), payload.size());
+    }
+
+    RecordHeader header{0, static_cast<uint32_t>(bodyLength), id, 0, static_cast<uint16_t>(topic.size()), type, flags};
+    header.checksum = checksumOf(header, body);
+    std::memcpy(segment.data + offset, &header, sizeof(header));
+    // The marker goes last so a partially written record is never taken as valid
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(segment.data + offset, &RECORD_MAGIC, sizeof(RECORD_MAGIC));
+    segment.used = offset + bytes;
+
+    if (m_config.sync == SyncPolicy::Always) {
+        syncActive();
+    }
+    return offset;
+}
+
+std::optional<uint64_t> OutboundJournal::append(std::string_view contentTopic, std::string_view payload, bool ephemeral)
+{
+    if (!enabled()) {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const qint64 bodyLength = static_cast<qint64>(contentTopic.size() + payload.size());
+    if (!m_active || contentTopic.size() > UINT16_MAX || recordBytes(bodyLength) > m_config.segmentBytes) {
+        ++m_counters.rejected;
+        return std::nullopt;
+    }
+
+    const uint64_t id = m_nextId++;
+    const qint64 offset = write(RECORD_APPEND, ephemeral ? FLAG_EPHEMERAL : 0, id, contentTopic, payload);
+    if (offset < 0) {
+        ++m_counters.rejected;
+        return std::nullopt;
+    }
+    m_entries.insert(id, Entry{m_active->sequence, offset, {}, State::Submitting});
+    ++m_active->live;
+    ++m_submitting;
+    ++m_counters.appended;
+    return id;
+}
+
+void OutboundJournal::bind(uint64_t id, std::string_view requestId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto entry = m_entries.find(id);
+    if (entry == m_entries.end()) {
+        return;
+    }
+    if (entry->state == State::Submitting && m_submitting > 0) {
+        --m_submitting;
+    }
+
+    const QByteArray key(requestId.data(), static_cast<qsizetype>(requestId.size()));
+    if (m_earlyRetired.remove(key)) {
+        retireLocked(id);
+        return;
+    }
+    if (!entry->requestId.isEmpty()) {
+        m_byRequest.remove(entry->requestId);
+    }
+    entry->requestId = key;
+    entry->state = State::Bound;
+    m_byRequest.insert(key, id);
+}
+
+void OutboundJournal::retire(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    retireLocked(id);
+}
+
+void OutboundJournal::retireRequest(std::string_view requestId)
+{
+    if (!enabled()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const QByteArray key = QByteArray::fromRawData(requestId.data(), static_cast<qsizetype>(requestId.size()));
+    const auto bound = m_byRequest.constFind(key);
+    if (bound != m_byRequest.constEnd()) {
+        retireLocked(*bound);
+        return;
+    }
+    // Only worth remembering while a send may still bind to it
+    if (m_submitting > 0) {
+        if (m_earlyRetired.size() >= 4096) {
+            m_earlyRetired.clear();
+        }
+        m_earlyRetired.insert(QByteArray(requestId.data(), static_cast<qsizetype>(requestId.size())));
+    }
+}
+
+void OutboundJournal::retireLocked(uint64_t id)
+{
+    const auto entry = m_entries.find(id);
+    if (entry == m_entries.end()) {
+        return;
+    }
+    if (entry->state == State::Submitting && m_submitting > 0) {
+        --m_submitting;
+    }
+    if (!entry->requestId.isEmpty()) {
+        m_byRequest.remove(entry->requestId);
+    }
+    const auto owner = m_segments.find(entry->segment);
+    if (owner != m_segments.end() && owner->second->live > 0) {
+        --owner->second->live;
+    }
+    m_entries.erase(entry);
+    ++m_counters.retired;
+
+    if (m_active && write(RECORD_RETIRE, 0, id, {}, {}) < 0) {
+        DELIVERY_LOG_WARNING("journal", .field("entry", static_cast<qint64>(id)).message("cannot record retirement"));
+    }
+    collectGarbage();
+}
+
+void OutboundJournal::collectGarbage()
+{
+    // Only the oldest segment may go: retirements it holds refer to entries in
+    // itself or in segments already deleted
+    while (!m_segments.empty()) {
+        const auto oldest = m_segments.begin();
+        if (oldest->second == m_active || oldest->second->live > 0) {
+            break;
+        }
+        const QString fileName = oldest->second->file.fileName();
+        m_segments.erase(oldest);
+        QFile::remove(fileName);
+    }
+}
+
+void OutboundJournal::syncActive()
+{
+    flushMapping(m_active->data, m_syncedTo, m_active->used);
+    m_syncedTo = m_active->used;
+    ++m_counters.syncs;
+}
+
+void OutboundJournal::markStopped()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->state == State::Bound) {
+            it->state = State::Replayable;
+        }
+    }
+}
+
+std::vector<OutboundJournal::Replay> OutboundJournal::pendingReplay()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Replay> replays;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->state != State::Replayable) {
+            continue;
+        }
+        const auto owner = m_segments.find(it->segment);
+        if (owner == m_segments.end()) {
+            continue;
+        }
+        const uchar* record = owner->second->data + it->offset;
+        RecordHeader header;
+        std::memcpy(&header, record, sizeof(header));
+        const char* body = reinterpret_cast<const char*>(record + sizeof(header));
+        replays.push_back(Replay{it.key(), QByteArray(body, header.topicLength),
+            QByteArray(body + header.topicLength, header.bodyLength - header.topicLength),
+            (header.flags & FLAG_EPHEMERAL) != 0});
+        // A concurrent start must not replay it a second time
+        it->state = State::Submitting;
+        ++m_submitting;
+    }
+    std::sort(replays.begin(), replays.end(), [](const Replay& a, const Replay& b) { return a.id < b.id; });
+    m_counters.replayed += replays.size();
+    return replays;
+}
+
+void OutboundJournal::deferReplay(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto entry = m_entries.find(id);
+    if (entry == m_entries.end() || entry->state != State::Submitting) {
+        return;
+    }
+    if (m_submitting > 0) {
+        --m_submitting;
+    }
+    entry->state = State::Replayable;
+}
+
+OutboundJournal::Stats OutboundJournal::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats snapshot = m_counters;
+    snapshot.enabled = enabled();
+    snapshot.segments = m_segments.size();
+    snapshot.pending = static_cast<size_t>(m_entries.size());
+    return snapshot;
+}
+
+void OutboundJournal::runFlusher()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopFlusher) {
+        m_flusherWake.wait_for(lock, m_config.syncInterval, [this]() { return m_stopFlusher; });
+        if (m_stopFlusher || !m_active || m_syncedTo == m_active->used) {
+            continue;
+        }
+        // msync may block on the disk; keep the segment alive but let appends go on
+        const std::shared_ptr<Segment> segment = m_active;
+        const qint64 from = m_syncedTo;
+        const qint64 to = segment->used;
+        lock.unlock();
+        flushMapping(segment->data, from, to);
+        lock.lock();
+        if (segment == m_active) {
+            m_syncedTo = std::max(m_syncedTo, to);
+        }
+        ++m_counters.syncs;
+    }
+}
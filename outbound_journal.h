@@ -0,0 +1,184 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "QExpected.h"
+
+/**
+ * @brief Write-ahead log of outbound messages that have not reached `message_sent`.
+ *
+ * Messages are appended to memory-mapped segment files before they are handed
+ * to liblogosdelivery and retired once their outcome is known. Retirement is
+ * itself an appended record, so segments are only ever written at their end;
+ * the oldest segment is deleted once every message in it has been retired.
+ * Whatever is still unretired when the journal is opened again, or was
+ * accepted but not yet reported on when the node stopped (@ref markStopped),
+ * is returned by @ref pendingReplay, so the plugin can send it after `start`.
+ * Sends that are merely in flight are never replayed.
+ *
+ * Each record carries a checksum and its marker is written last, so a record
+ * torn by a crash ends the scan of its segment instead of being replayed.
+ * Appending is a copy into the mapping; @ref SyncPolicy decides when the
+ * mapping is flushed to disk.
+ */
+class OutboundJournal {
+public:
+    enum class SyncPolicy : uint8_t {
+        None,     ///< Left to the OS; survives a process crash but not a power loss.
+        Interval, ///< Flushed by a background thread every `syncInterval`.
+        Always,   ///< Flushed before every append returns.
+    };
+
+    struct Config {
+        QString directory;
+        uint32_t segmentBytes{8u << 20};
+        SyncPolicy sync{SyncPolicy::Interval};
+        std::chrono::milliseconds syncInterval{100};
+    };
+
+    /**
+     * @brief Message to send again after a restart.
+     */
+    struct Replay {
+        uint64_t id{0};
+        QByteArray contentTopic;
+        QByteArray payload;
+        bool ephemeral{false};
+    };
+
+    struct Stats {
+        bool enabled{false};
+        size_t segments{0};
+        size_t pending{0};
+        uint64_t appended{0};
+        uint64_t retired{0};
+        uint64_t recovered{0};
+        uint64_t replayed{0};
+        uint64_t rejected{0};
+        uint64_t syncs{0};
+    };
+
+    OutboundJournal() = default;
+    ~OutboundJournal();
+
+    OutboundJournal(const OutboundJournal&) = delete;
+    OutboundJournal& operator=(const OutboundJournal&) = delete;
+
+    /**
+     * @brief Opens the journal in `config.directory` and recovers its unretired messages.
+     *
+     * A journal that is already open is closed first.
+     */
+    QExpected<void> open(const Config& config);
+
+    /**
+     * @brief Flushes and closes the journal; appends are ignored afterwards.
+     */
+    void close();
+
+    bool enabled() const { return m_enabled.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Journals a message about to be sent.
+     * @return Its entry id, or nothing when the journal is closed or the
+     *         message does not fit in a segment (counted as `rejected`).
+     */
+    std::optional<uint64_t> append(std::string_view contentTopic, std::string_view payload, bool ephemeral);
+
+    /**
+     * @brief Associates entry @p id with the request id liblogosdelivery returned for it.
+     */
+    void bind(uint64_t id, std::string_view requestId);
+
+    /**
+     * @brief Retires entry @p id; unknown ids are ignored.
+     */
+    void retire(uint64_t id);
+
+    /**
+     * @brief Retires the entry bound to @p requestId.
+     *
+     * An outcome that overtakes the send acknowledgement is remembered and
+     * applied by @ref bind.
+     */
+    void retireRequest(std::string_view requestId);
+
+    /**
+     * @brief Marks every bound entry for replay; called once the node has
+     * stopped, as their outcome will not be reported any more.
+     */
+    void markStopped();
+
+    /**
+     * @brief Messages recovered by @ref open or marked by @ref markStopped, oldest first.
+     *
+     * The returned entries count as being submitted again until they are
+     * bound, retired or handed back with @ref deferReplay.
+     */
+    std::vector<Replay> pendingReplay();
+
+    /**
+     * @brief Hands entry @p id back for the next @ref pendingReplay after its replay failed.
+     */
+    void deferReplay(uint64_t id);
+
+    Stats stats() const;
+
+private:
+    enum class State : uint8_t {
+        Submitting, ///< Appended; the send call has not returned yet.
+        Bound,      ///< Accepted by liblogosdelivery under a request id.
+        Replayable, ///< Found unretired on open, or bound when the node stopped.
+    };
+
+    struct Segment;
+
+    struct Entry {
+        uint64_t segment{0};
+        qint64 offset{0};
+        QByteArray requestId;
+        State state{State::Submitting};
+    };
+
+    // Callers hold m_mutex
+    void recoverSegment(Segment& segment);
+    bool rotate();
+    qint64 write(uint8_t type, uint8_t flags, uint64_t id, std::string_view topic, std::string_view payload);
+    void retireLocked(uint64_t id);
+    void collectGarbage();
+    void syncActive();
+
+    void runFlusher();
+
+    Config m_config;
+    std::atomic<bool> m_enabled{false};
+
+    mutable std::mutex m_mutex;
+    std::map<uint64_t, std::shared_ptr<Segment>> m_segments;
+    std::shared_ptr<Segment> m_active;
+    QHash<uint64_t, Entry> m_entries;
+    QHash<QByteArray, uint64_t> m_byRequest;
+    QSet<QByteArray> m_earlyRetired;
+    size_t m_submitting{0};
+    uint64_t m_nextId{1};
+    qint64 m_syncedTo{0};
+    Stats m_counters;
+
+    std::condition_variable m_flusherWake;
+    bool m_stopFlusher{false};
+    std::thread m_flusher;
+};
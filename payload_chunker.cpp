@@ -0,0 +1,205 @@
+#include "payload_chunker.h"
+
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QtEndian>
+#include <algorithm>
+
+namespace {
+// base64 of the first three bytes is always kBase64Prefix
+constexpr char HEADER_MAGIC[] = {'\x0e', '\x5c', '\x6b'};
+constexpr char FORMAT_VERSION = '\x01';
+constexpr qsizetype TRANSFER_ID_BYTES = 16;
+constexpr auto MAX_SWEEP_INTERVAL = std::chrono::seconds(1);
+
+struct ChunkHeader {
+    QByteArray transferId;
+    uint32_t index{0};
+    uint32_t count{0};
+    uint32_t offset{0};
+    uint32_t totalBytes{0};
+};
+
+void appendUint32(QByteArray& out, uint32_t value)
+{
+    const uint32_t bigEndian = qToBigEndian(value);
+    out.append(reinterpret_cast<const char*>(&bigEndian), sizeof(bigEndian));
+}
+
+// Parses the header of @p chunk, checking it against the chunk's own length.
+bool parseHeader(const QByteArray& chunk, ChunkHeader& header)
+{
+    if (chunk.size() < PayloadChunker::kHeaderBytes
+        || !std::equal(std::begin(HEADER_MAGIC), std::end(HEADER_MAGIC), chunk.constBegin())
+        || chunk.at(sizeof(HEADER_MAGIC)) != FORMAT_VERSION) {
+        return false;
+    }
+    const char* fields = chunk.constData() + sizeof(HEADER_MAGIC) + 1;
+    header.transferId = QByteArray(fields, TRANSFER_ID_BYTES);
+    fields += TRANSFER_ID_BYTES;
+    header.index = qFromBigEndian<uint32_t>(fields);
+    header.count = qFromBigEndian<uint32_t>(fields + 4);
+    header.offset = qFromBigEndian<uint32_t>(fields + 8);
+    header.totalBytes = qFromBigEndian<uint32_t>(fields + 12);
+
+    const uint64_t dataBytes = static_cast<uint64_t>(chunk.size() - PayloadChunker::kHeaderBytes);
+    return header.count > 0 && header.count <= PayloadChunker::kMaxChunks && header.index < header.count
+        && uint64_t(header.offset) + dataBytes <= header.totalBytes;
+}
+} // namespace
+
+void PayloadChunker::configure(const Config& config)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+    m_transfers.clear();
+    m_bufferedBytes = 0;
+    m_nextSweep = Clock::time_point();
+}
+
+std::vector<QByteArray> PayloadChunker::split(const QByteArray& payload, qsizetype chunkBytes)
+{
+    std::vector<QByteArray> chunks;
+    if (chunkBytes <= 0 || static_cast<uint64_t>(payload.size()) > UINT32_MAX) {
+        return chunks;
+    }
+    const qsizetype count = std::max<qsizetype>(1, (payload.size() + chunkBytes - 1) / chunkBytes);
+    if (count > kMaxChunks) {
+        return chunks;
+    }
+
+    QByteArray header;
+    header.reserve(kHeaderBytes);
+    header.append(HEADER_MAGIC, sizeof(HEADER_MAGIC)).append(FORMAT_VERSION);
+    header.resize(sizeof(HEADER_MAGIC) + 1 + TRANSFER_ID_BYTES);
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32*>(header.data() + sizeof(HEADER_MAGIC) + 1),
+        TRANSFER_ID_BYTES / sizeof(quint32));
+
+    chunks.reserve(count);
+    for (qsizetype index = 0; index < count; ++index) {
+        const qsizetype offset = index * chunkBytes;
+        const qsizetype dataBytes = std::min(chunkBytes, payload.size() - offset);
+        QByteArray chunk;
+        chunk.reserve(kHeaderBytes + dataBytes);
+        chunk.append(header);
+        appendUint32(chunk, static_cast<uint32_t>(index));
+        appendUint32(chunk, static_cast<uint32_t>(count));
+        appendUint32(chunk, static_cast<uint32_t>(offset));
+        appendUint32(chunk, static_cast<uint32_t>(payload.size()));
+        chunk.append(payload.constData() + offset, dataBytes);
+        chunks.push_back(std::move(chunk));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_counters.transfersSent;
+    m_counters.chunksSent += chunks.size();
+    return chunks;
+}
+
+void PayloadChunker::erase(QHash<QByteArray, Transfer>::iterator transfer)
+{
+    m_bufferedBytes -= transfer->buffer.size();
+    m_transfers.erase(transfer);
+}
+
+void PayloadChunker::expire(Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    expireLocked(now);
+}
+
+void PayloadChunker::expireLocked(Clock::time_point now)
+{
+    if (now < m_nextSweep) {
+        return;
+    }
+    m_nextSweep = now + std::min<Clock::duration>(m_config.timeout, MAX_SWEEP_INTERVAL);
+    for (auto it = m_transfers.begin(); it != m_transfers.end();) {
+        if (it->deadline <= now) {
+            m_bufferedBytes -= it->buffer.size();
+            it = m_transfers.erase(it);
+            ++m_counters.expired;
+        } else {
+            ++it;
+        }
+    }
+}
+
+PayloadChunker::Outcome PayloadChunker::add(const QByteArray& contentTopic, const QByteArray& chunk, Clock::time_point now)
+{
+    Outcome outcome;
+    ChunkHeader header;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_config.maxBytes == 0) {
+        return outcome;
+    }
+    if (!parseHeader(chunk, header)) {
+        ++m_counters.invalid;
+        return outcome;
+    }
+    ++m_counters.chunksReceived;
+    expireLocked(now);
+
+    outcome.status = Status::Dropped;
+    outcome.transferId = header.transferId;
+    outcome.totalChunks = header.count;
+    outcome.totalBytes = header.totalBytes;
+
+    const QByteArray key = contentTopic + '\0' + header.transferId;
+    auto transfer = m_transfers.find(key);
+    if (transfer == m_transfers.end()) {
+        if (header.totalBytes > m_config.maxBytes - m_bufferedBytes || m_transfers.size() >= kMaxTransfers) {
+            ++m_counters.rejected;
+            return outcome;
+        }
+        Transfer created;
+        created.buffer.resize(header.totalBytes);
+        created.received.assign(header.count, false);
+        m_bufferedBytes += header.totalBytes;
+        transfer = m_transfers.insert(key, std::move(created));
+    } else if (transfer->buffer.size() != qsizetype(header.totalBytes) || transfer->received.size() != header.count) {
+        // Chunks of one transfer must agree on its shape
+        ++m_counters.invalid;
+        erase(transfer);
+        return outcome;
+    }
+
+    if (transfer->received[header.index]) {
+        ++m_counters.duplicates;
+        return outcome;
+    }
+    const qsizetype dataBytes = chunk.size() - kHeaderBytes;
+    std::copy_n(chunk.constData() + kHeaderBytes, dataBytes, transfer->buffer.data() + header.offset);
+    transfer->received[header.index] = true;
+    ++transfer->receivedChunks;
+    transfer->receivedBytes += dataBytes;
+    transfer->deadline = now + m_config.timeout;
+
+    outcome.receivedChunks = transfer->receivedChunks;
+    outcome.receivedBytes = transfer->receivedBytes;
+    if (transfer->receivedChunks < header.count) {
+        outcome.status = Status::Progress;
+        return outcome;
+    }
+    if (transfer->receivedBytes != header.totalBytes) {
+        ++m_counters.invalid;
+        erase(transfer);
+        return outcome;
+    }
+    outcome.status = Status::Complete;
+    outcome.payload = std::move(transfer->buffer);
+    transfer->buffer = QByteArray();
+    m_bufferedBytes -= header.totalBytes;
+    m_transfers.erase(transfer);
+    ++m_counters.completed;
+    return outcome;
+}
+
+PayloadChunker::Stats PayloadChunker::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats snapshot = m_counters;
+    snapshot.maxBytes = m_config.maxBytes;
+    snapshot.partial = static_cast<size_t>(m_transfers.size());
+    snapshot.bufferedBytes = m_bufferedBytes;
+    return snapshot;
+}
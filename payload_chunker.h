@@ -0,0 +1,139 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Splits payloads larger than one message into chunks and reassembles them.
+ *
+ * Every chunk carries a 36-byte header: a 3-byte magic, a format version, a
+ * random 16-byte transfer id shared by all chunks of a payload, and the
+ * chunk's index, the chunk count, its byte offset and the payload's total
+ * size (big endian). Chunks may arrive in any order. As with compression, the
+ * magic makes every chunk's base64 form start with @ref kBase64Prefix, so
+ * other messages are never decoded to look for a header.
+ *
+ * Reassembly allocates a transfer's whole buffer on its first chunk, within
+ * a budget of `Config::maxBytes` shared by all partial transfers; a transfer
+ * that does not fit is dropped. A transfer that receives no chunk for
+ * `Config::timeout` is discarded by @ref expire.
+ */
+class PayloadChunker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief base64 form of the header's first 3 bytes.
+     */
+    static constexpr std::string_view kBase64Prefix = "Dlxr";
+
+    static constexpr qsizetype kHeaderBytes = 36;
+
+    /**
+     * @brief Room left in each message for its other fields and the RLN proof.
+     */
+    static constexpr qsizetype kEnvelopeReserveBytes = 2048;
+
+    static constexpr uint32_t kMaxChunks = 65535;
+
+    /**
+     * @brief Most transfers being reassembled at once.
+     */
+    static constexpr qsizetype kMaxTransfers = 1024;
+
+    struct Config {
+        uint64_t maxBytes{64u << 20}; ///< `0` disables reassembly; chunks are emitted as received.
+        std::chrono::milliseconds timeout{60000};
+    };
+
+    enum class Status : uint8_t {
+        NotChunk, ///< No valid chunk header; the message is a regular one.
+        Progress, ///< Chunk stored; the transfer is still incomplete.
+        Complete, ///< Last missing chunk; `payload` holds the reassembled payload.
+        Dropped,  ///< Duplicate, inconsistent or over the memory budget.
+    };
+
+    struct Outcome {
+        Status status{Status::NotChunk};
+        QByteArray transferId;
+        uint32_t receivedChunks{0};
+        uint32_t totalChunks{0};
+        uint64_t receivedBytes{0};
+        uint64_t totalBytes{0};
+        QByteArray payload;
+    };
+
+    struct Stats {
+        uint64_t maxBytes{0};
+        size_t partial{0};
+        uint64_t bufferedBytes{0};
+        uint64_t transfersSent{0};
+        uint64_t chunksSent{0};
+        uint64_t chunksReceived{0};
+        uint64_t completed{0};
+        uint64_t expired{0};
+        uint64_t rejected{0};
+        uint64_t duplicates{0};
+        uint64_t invalid{0};
+    };
+
+    /**
+     * @brief Resets reassembly, discarding partial transfers.
+     */
+    void configure(const Config& config);
+
+    /**
+     * @brief Chunks of @p payload, each carrying at most @p chunkBytes of it.
+     * @return An empty list when @p chunkBytes is not positive or the payload needs
+     *         more than @ref kMaxChunks chunks.
+     */
+    std::vector<QByteArray> split(const QByteArray& payload, qsizetype chunkBytes);
+
+    /**
+     * @brief Whether a base64 payload carries the chunk header.
+     */
+    static bool isChunkBase64(std::string_view base64Payload)
+    {
+        return base64Payload.substr(0, kBase64Prefix.size()) == kBase64Prefix;
+    }
+
+    /**
+     * @brief Feeds a received chunk of a transfer on @p contentTopic.
+     */
+    Outcome add(const QByteArray& contentTopic, const QByteArray& chunk, Clock::time_point now);
+
+    /**
+     * @brief Discards transfers idle for longer than `Config::timeout`.
+     *
+     * @ref add also does this, but only while chunks keep arriving, so the
+     * owner calls it periodically to bound the memory of abandoned transfers.
+     */
+    void expire(Clock::time_point now);
+
+    Stats stats() const;
+
+private:
+    struct Transfer {
+        QByteArray buffer;
+        std::vector<bool> received;
+        uint32_t receivedChunks{0};
+        uint64_t receivedBytes{0};
+        Clock::time_point deadline;
+    };
+
+    // Callers hold m_mutex
+    void expireLocked(Clock::time_point now);
+    void erase(QHash<QByteArray, Transfer>::iterator transfer);
+
+    mutable std::mutex m_mutex;
+    Config m_config;
+    QHash<QByteArray, Transfer> m_transfers; // topic + '\0' + transfer id
+    uint64_t m_bufferedBytes{0};
+    Clock::time_point m_nextSweep;
+    Stats m_counters;
+};
@@ -0,0 +1,170 @@
+#include "payload_compressor.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+// base64 of the first three bytes is always kBase64Prefix
+constexpr char HEADER_MAGIC[] = {'\x0e', '\x5c', '\x5a'};
+constexpr char CODEC_ZLIB = '\x01';
+constexpr qsizetype HEADER_BYTES = sizeof(HEADER_MAGIC) + 1;
+// qCompress output starts with the uncompressed length, big endian
+constexpr qsizetype LENGTH_BYTES = 4;
+const QString OVERFLOW_TOPIC = QStringLiteral("*");
+
+bool hasMagic(const QByteArray& payload)
+{
+    return payload.size() >= qsizetype(sizeof(HEADER_MAGIC))
+        && std::equal(std::begin(HEADER_MAGIC), std::end(HEADER_MAGIC), payload.constBegin());
+}
+
+uint64_t elapsedNs(std::chrono::steady_clock::time_point since)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - since).count());
+}
+} // namespace
+
+void PayloadCompressor::configure(const Config& config)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+    m_config.level = std::clamp(config.level, 1, 9);
+    m_exact.clear();
+    m_prefixes.clear();
+    for (const QString& topic : config.topics) {
+        if (topic.endsWith('*')) {
+            m_prefixes << topic.chopped(1);
+        } else if (!topic.isEmpty()) {
+            m_exact.insert(topic);
+        }
+    }
+    m_stats.clear();
+}
+
+bool PayloadCompressor::matches(const QString& contentTopic) const
+{
+    if (m_exact.contains(contentTopic)) {
+        return true;
+    }
+    return std::any_of(m_prefixes.cbegin(), m_prefixes.cend(),
+        [&contentTopic](const QString& prefix) { return contentTopic.startsWith(prefix); });
+}
+
+bool PayloadCompressor::enabledFor(const QString& contentTopic) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return matches(contentTopic);
+}
+
+PayloadCompressor::TopicStats& PayloadCompressor::statsFor(const QString& contentTopic)
+{
+    auto it = m_stats.find(contentTopic);
+    if (it != m_stats.end()) {
+        return *it;
+    }
+    return m_stats[m_stats.size() < kMaxTrackedTopics ? contentTopic : OVERFLOW_TOPIC];
+}
+
+QByteArray PayloadCompressor::compress(const QString& contentTopic, const QByteArray& payload)
+{
+    int level = 0;
+    qsizetype minBytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!matches(contentTopic)) {
+            return payload;
+        }
+        level = m_config.level;
+        minBytes = m_config.minBytes;
+    }
+
+    const bool mustWrap = hasMagic(payload);
+    if (payload.size() < minBytes && !mustWrap) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TopicStats& stats = statsFor(contentTopic);
+        ++stats.skipped;
+        stats.rawBytes += payload.size();
+        stats.wireBytes += payload.size();
+        return payload;
+    }
+
+    const auto startedAt = std::chrono::steady_clock::now();
+    QByteArray wire;
+    wire.reserve(HEADER_BYTES + LENGTH_BYTES + payload.size() / 2);
+    wire.append(HEADER_MAGIC, sizeof(HEADER_MAGIC)).append(CODEC_ZLIB);
+    wire.append(qCompress(payload, level));
+    const uint64_t spentNs = elapsedNs(startedAt);
+
+    const bool smaller = wire.size() < payload.size();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TopicStats& stats = statsFor(contentTopic);
+    stats.compressNs += spentNs;
+    stats.rawBytes += payload.size();
+    if (!smaller && !mustWrap) {
+        ++stats.skipped;
+        stats.wireBytes += payload.size();
+        return payload;
+    }
+    ++stats.compressed;
+    stats.wireBytes += wire.size();
+    return wire;
+}
+
+std::optional<QByteArray> PayloadCompressor::decompress(const QString& contentTopic, const QByteArray& wirePayload)
+{
+    if (!hasMagic(wirePayload)) {
+        return std::nullopt;
+    }
+
+    auto failed = [&]() -> std::optional<QByteArray> {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++statsFor(contentTopic).decompressFailed;
+        return std::nullopt;
+    };
+    if (wirePayload.size() < HEADER_BYTES + LENGTH_BYTES || wirePayload.at(sizeof(HEADER_MAGIC)) != CODEC_ZLIB) {
+        return failed();
+    }
+    // Refuse to inflate anything beyond the limit before allocating for it
+    const auto* body = reinterpret_cast<const uchar*>(wirePayload.constData() + HEADER_BYTES);
+    const qsizetype rawSize = (qsizetype(body[0]) << 24) | (qsizetype(body[1]) << 16) | (qsizetype(body[2]) << 8)
+        | qsizetype(body[3]);
+    if (rawSize > kMaxDecompressedBytes) {
+        return failed();
+    }
+
+    const auto startedAt = std::chrono::steady_clock::now();
+    QByteArray raw = qUncompress(body, wirePayload.size() - HEADER_BYTES);
+    const uint64_t spentNs = elapsedNs(startedAt);
+    if (raw.size() != rawSize) {
+        return failed();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TopicStats& stats = statsFor(contentTopic);
+    ++stats.decompressed;
+    stats.receivedWireBytes += wirePayload.size();
+    stats.receivedRawBytes += raw.size();
+    stats.decompressNs += spentNs;
+    return raw;
+}
+
+PayloadCompressor::Config PayloadCompressor::config() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_config;
+}
+
+std::vector<std::pair<QString, PayloadCompressor::TopicStats>> PayloadCompressor::stats() const
+{
+    std::vector<std::pair<QString, TopicStats>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        snapshot.reserve(m_stats.size());
+        for (auto it = m_stats.cbegin(); it != m_stats.cend(); ++it) {
+            snapshot.emplace_back(it.key(), it.value());
+        }
+    }
+    std::sort(snapshot.begin(), snapshot.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    return snapshot;
+}
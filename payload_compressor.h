@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Opt-in payload compression for selected content topics.
+ *
+ * Payloads sent on a configured topic are compressed with zlib (`qCompress`)
+ * and prefixed with a 4-byte header: a 3-byte magic and a codec id. Payloads
+ * that would not get smaller are sent unchanged. Any received payload that
+ * starts with the header is decompressed, whatever the local configuration,
+ * so peers can enable compression independently.
+ *
+ * The magic is chosen so that the header always base64-encodes to the same
+ * prefix (@ref kBase64Prefix); receivers recognise compressed messages
+ * without decoding the payload of every message.
+ *
+ * Per-topic counters of bytes before and after compression and of the time
+ * spent in the codec are kept for the topics that use it.
+ */
+class PayloadCompressor {
+public:
+    /**
+     * @brief base64 form of the header's first 3 bytes.
+     */
+    static constexpr std::string_view kBase64Prefix = "Dlxa";
+
+    /**
+     * @brief Largest payload a compressed message may expand to.
+     */
+    static constexpr qsizetype kMaxDecompressedBytes = 16 << 20;
+
+    /**
+     * @brief Most topics with their own counters; later ones are counted under `*`.
+     */
+    static constexpr qsizetype kMaxTrackedTopics = 1024;
+
+    struct Config {
+        QStringList topics;  ///< Exact content topics, or prefixes ending in `*`.
+        int level{1};        ///< zlib level, 1 (fastest) to 9.
+        qsizetype minBytes{256};
+    };
+
+    struct TopicStats {
+        // Sent; skipped payloads were below `minBytes` or no smaller compressed
+        uint64_t compressed{0};
+        uint64_t skipped{0};
+        uint64_t rawBytes{0};
+        uint64_t wireBytes{0};
+        uint64_t compressNs{0};
+        // Received
+        uint64_t decompressed{0};
+        uint64_t decompressFailed{0};
+        uint64_t receivedWireBytes{0};
+        uint64_t receivedRawBytes{0};
+        uint64_t decompressNs{0};
+    };
+
+    void configure(const Config& config);
+
+    /**
+     * @brief Whether sends on @p contentTopic are compressed.
+     */
+    bool enabledFor(const QString& contentTopic) const;
+
+    /**
+     * @brief Payload to put on the wire for @p contentTopic.
+     *
+     * A payload that itself starts with the header magic is always wrapped,
+     * so receivers cannot mistake it for a compressed one.
+     */
+    QByteArray compress(const QString& contentTopic, const QByteArray& payload);
+
+    /**
+     * @brief Whether a base64 payload carries the compression header.
+     */
+    static bool isCompressedBase64(std::string_view base64Payload)
+    {
+        return base64Payload.substr(0, kBase64Prefix.size()) == kBase64Prefix;
+    }
+
+    /**
+     * @brief Original payload of a received wire payload that carries the header.
+     * @return Nothing when the payload is not compressed or is corrupt.
+     */
+    std::optional<QByteArray> decompress(const QString& contentTopic, const QByteArray& wirePayload);
+
+    Config config() const;
+    std::vector<std::pair<QString, TopicStats>> stats() const;
+
+private:
+    // Callers hold m_mutex
+    bool matches(const QString& contentTopic) const;
+    TopicStats& statsFor(const QString& contentTopic);
+
+    mutable std::mutex m_mutex;
+    Config m_config;
+    QSet<QString> m_exact;
+    QStringList m_prefixes;
+    QHash<QString, TopicStats> m_stats;
+};
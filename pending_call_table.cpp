@@ -0,0 +1,83 @@
+#include "pending_call_table.h"
+
+PendingCallTable& PendingCallTable::instance()
+{
+    static PendingCallTable table;
+    return table;
+}
+
+PendingCallTable::PendingCallTable() : m_slots(std::make_unique<Slot[]>(kCapacity)) {}
+
+void* PendingCallTable::makeKey(size_t index, uint64_t generation)
+{
+    const uintptr_t key = (static_cast<uintptr_t>(generation) << kIndexBits) | index;
+    return reinterpret_cast<void*>(key);
+}
+
+PendingCallTable::Slot* PendingCallTable::slotFor(void* key, uint64_t& generation) const
+{
+    const auto raw = reinterpret_cast<uintptr_t>(key);
+    generation = static_cast<uint64_t>(raw >> kIndexBits) & kGenerationMask;
+    return &m_slots[raw & (kCapacity - 1)];
+}
+
+void* PendingCallTable::claim(CompletionFn completion, void* target)
+{
+    const size_t start = m_nextHint.fetch_add(1, std::memory_order_relaxed);
+    for (size_t probe = 0; probe < kCapacity; ++probe) {
+        const size_t index = (start + probe) & (kCapacity - 1);
+        Slot& slot = m_slots[index];
+        uint64_t tag = slot.tag.load(std::memory_order_relaxed);
+        if (stateOf(tag) != Free) {
+            continue;
+        }
+        const uint64_t generation = generationOf(tag);
+        if (!slot.tag.compare_exchange_strong(tag, makeTag(generation, Claiming), std::memory_order_acquire)) {
+            continue;
+        }
+        slot.completion = completion;
+        slot.target = target;
+        slot.tag.store(makeTag(generation, Pending), std::memory_order_release);
+        m_inUse.fetch_add(1, std::memory_order_relaxed);
+        return makeKey(index, generation);
+    }
+    return nullptr;
+}
+
+bool PendingCallTable::cancel(void* key)
+{
+    uint64_t generation = 0;
+    Slot* slot = slotFor(key, generation);
+    uint64_t expected = makeTag(generation, Pending);
+    if (!slot->tag.compare_exchange_strong(expected, makeTag(nextGeneration(generation), Free),
+            std::memory_order_acq_rel)) {
+        return false;
+    }
+    m_inUse.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+void PendingCallTable::dispatch(int callerRet, const char* msg, size_t len, void* key)
+{
+    instance().complete(callerRet, msg, len, key);
+}
+
+void PendingCallTable::complete(int callerRet, const char* msg, size_t len, void* key)
+{
+    uint64_t generation = 0;
+    Slot* slot = slotFor(key, generation);
+    uint64_t expected = makeTag(generation, Pending);
+    if (!slot->tag.compare_exchange_strong(expected, makeTag(generation, Completing),
+            std::memory_order_acq_rel)) {
+        // Cancelled after a timeout, or a duplicate callback: the caller is gone
+        return;
+    }
+
+    const CompletionFn completion = slot->completion;
+    void* target = slot->target;
+    completion(target, callerRet, msg, len);
+
+    // The completion no longer touches the slot; hand it back with a fresh generation
+    slot->tag.store(makeTag(nextGeneration(generation), Free), std::memory_order_release);
+    m_inUse.fetch_sub(1, std::memory_order_relaxed);
+}
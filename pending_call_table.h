@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Fixed-capacity table of FFI calls waiting for their liblogosdelivery callback.
+ *
+ * Each in-flight call claims a slot and hands the FFI an opaque key that
+ * encodes the slot index and the slot's generation. Claiming, completing and
+ * cancelling are single compare-and-swap operations on the slot's tag, so no
+ * lock or allocation sits on the call path and all call sites share one table.
+ *
+ * The generation protects against late callbacks: once a slot is cancelled
+ * (e.g. after a timeout) or completed, its generation moves on and any
+ * callback still carrying the old key is ignored.
+ */
+class PendingCallTable {
+public:
+    /**
+     * @brief Invoked on the callback thread with the target registered at claim time.
+     */
+    using CompletionFn = void (*)(void* target, int callerRet, const char* msg, size_t len);
+
+    static constexpr size_t kIndexBits = 14;
+    static constexpr size_t kCapacity = size_t{1} << kIndexBits;
+
+    /**
+     * @brief Process-wide table shared by every call site.
+     */
+    static PendingCallTable& instance();
+
+    PendingCallTable();
+    PendingCallTable(const PendingCallTable&) = delete;
+    PendingCallTable& operator=(const PendingCallTable&) = delete;
+
+    /**
+     * @brief Claims a free slot for a call about to be initiated.
+     * @param completion Function run once when the callback arrives.
+     * @param target Opaque pointer passed to @p completion.
+     * @return Key to pass as FFI `userData`, or `nullptr` when the table is full.
+     */
+    void* claim(CompletionFn completion, void* target);
+
+    /**
+     * @brief Cancels a pending call so that its callback will be ignored.
+     *
+     * @return `true` if the slot was released and the completion will never run;
+     *         `false` if the callback already claimed it, in which case the
+     *         completion is running or has run and the caller must wait for it.
+     */
+    bool cancel(void* key);
+
+    /**
+     * @brief C callback handed to liblogosdelivery for every call in this table.
+     */
+    static void dispatch(int callerRet, const char* msg, size_t len, void* key);
+
+    /**
+     * @brief Approximate number of claimed slots.
+     */
+    size_t inUse() const { return m_inUse.load(std::memory_order_relaxed); }
+
+private:
+    enum State : uint64_t {
+        Free = 0,
+        Claiming = 1,
+        Pending = 2,
+        Completing = 3,
+    };
+
+    // Generations must fit both the key (next to the index) and the tag (next to the state)
+    static constexpr uint64_t kGenerationBits =
+        sizeof(uintptr_t) * 8 - kIndexBits < 62 ? sizeof(uintptr_t) * 8 - kIndexBits : 62;
+    static constexpr uint64_t kGenerationMask = (uint64_t{1} << kGenerationBits) - 1;
+
+    static constexpr uint64_t makeTag(uint64_t generation, State state)
+    {
+        return ((generation & kGenerationMask) << 2) | state;
+    }
+    static uint64_t generationOf(uint64_t tag) { return tag >> 2; }
+    static State stateOf(uint64_t tag) { return static_cast<State>(tag & 3); }
+
+    // Generations start at 1 and skip 0 on wrap-around, so no key is ever null
+    static uint64_t nextGeneration(uint64_t generation)
+    {
+        const uint64_t next = (generation + 1) & kGenerationMask;
+        return next == 0 ? 1 : next;
+    }
+
+    struct alignas(32) Slot {
+        std::atomic<uint64_t> tag{makeTag(1, Free)};
+        CompletionFn completion{nullptr};
+        void* target{nullptr};
+    };
+
+    static void* makeKey(size_t index, uint64_t generation);
+    Slot* slotFor(void* key, uint64_t& generation) const;
+    void complete(int callerRet, const char* msg, size_t len, void* key);
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<size_t> m_nextHint{0};
+    std::atomic<size_t> m_inUse{0};
+};
@@ -0,0 +1,313 @@
+#include "received_store.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr uint32_t STORE_MAGIC = 0x31535244;  // "DRS1"
+constexpr uint32_t STORE_VERSION = 1;
+constexpr uint32_t RECORD_MAGIC = 0x314d5244; // "DRM1"
+constexpr uint32_t WRAP_MAGIC = 0x31575244;   // "DRW1": the rest of the ring is unused
+constexpr uint64_t MIN_CAPACITY_BYTES = 1u << 20;
+
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t bodyLength;
+    int64_t timestampNs;
+    int64_t storedAtMs;
+    uint32_t checksum;
+    uint16_t topicLength;
+    uint16_t hashLength;
+};
+static_assert(sizeof(RecordHeader) == 32, "received store record header must stay 32 bytes");
+
+constexpr uint64_t recordBytes(uint64_t bodyLength)
+{
+    return (sizeof(RecordHeader) + bodyLength + 7) & ~uint64_t(7);
+}
+
+uint32_t checksumOf(const RecordHeader& header, const uchar* body)
+{
+    // FNV-1a over the header fields and the body
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](const void* data, size_t length) {
+        const auto* bytes = static_cast<const uchar*>(data);
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+    };
+    mix(&header.timestampNs, sizeof(header.timestampNs));
+    mix(&header.storedAtMs, sizeof(header.storedAtMs));
+    mix(&header.topicLength, sizeof(header.topicLength));
+    mix(&header.hashLength, sizeof(header.hashLength));
+    mix(body, header.bodyLength);
+    return hash;
+}
+
+int64_t nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
+struct ReceivedStore::FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    uint64_t head; // positions grow forever; the ring offset is position % capacity
+    uint64_t tail;
+    uint8_t reserved[32];
+};
+
+ReceivedStore::~ReceivedStore()
+{
+    close();
+}
+
+QExpected<void> ReceivedStore::open(const Config& config)
+{
+    static_assert(sizeof(FileHeader) == 64, "received store file header must stay 64 bytes");
+    close();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+    m_counters = Stats{};
+    const uint64_t capacity = std::max(config.capacityBytes, MIN_CAPACITY_BYTES) & ~uint64_t(7);
+    const qint64 fileBytes = static_cast<qint64>(sizeof(FileHeader) + capacity);
+
+    QFileInfo(config.path).dir().mkpath(".");
+    m_file.setFileName(config.path);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        return QExpected<void>::err(QStringLiteral("received store: cannot open %1: %2")
+            .arg(config.path, m_file.errorString()));
+    }
+    // A store of another size cannot be reinterpreted; start over
+    const bool fresh = m_file.size() != fileBytes;
+    if (fresh && !(m_file.resize(0) && m_file.resize(fileBytes))) {
+        m_file.close();
+        return QExpected<void>::err(QStringLiteral("received store: cannot size %1: %2")
+            .arg(config.path, m_file.errorString()));
+    }
+    m_map = m_file.map(0, fileBytes);
+    if (!m_map) {
+        m_file.close();
+        return QExpected<void>::err(QStringLiteral("received store: cannot map %1: %2")
+            .arg(config.path, m_file.errorString()));
+    }
+
+    m_header = reinterpret_cast<FileHeader*>(m_map);
+    m_data = m_map + sizeof(FileHeader);
+    m_capacity = capacity;
+    if (fresh || m_header->magic != STORE_MAGIC || m_header->version != STORE_VERSION
+        || m_header->capacity != capacity || m_header->head < m_header->tail
+        || m_header->head - m_header->tail > capacity) {
+        std::memset(m_header, 0, sizeof(FileHeader));
+        m_header->magic = STORE_MAGIC;
+        m_header->version = STORE_VERSION;
+        m_header->capacity = capacity;
+    }
+    recover();
+
+    m_enabled.store(true, std::memory_order_release);
+    return QExpected<void>::ok();
+}
+
+void ReceivedStore::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_enabled.store(false, std::memory_order_release);
+    if (m_map) {
+        m_file.unmap(m_map);
+    }
+    m_file.close();
+    m_map = nullptr;
+    m_header = nullptr;
+    m_data = nullptr;
+    m_index.clear();
+    m_messages = 0;
+}
+
+uchar* ReceivedStore::at(uint64_t position) const
+{
+    return m_data + position % m_capacity;
+}
+
+void ReceivedStore::recover()
+{
+    uint64_t position = m_header->tail;
+    const uint64_t head = m_header->head;
+    while (position < head) {
+        const uint64_t room = m_capacity - position % m_capacity;
+        if (room < sizeof(RecordHeader)) {
+            position += room;
+            continue;
+        }
+        RecordHeader header;
+        std::memcpy(&header, at(position), sizeof(header));
+        if (header.magic == WRAP_MAGIC) {
+            position += room;
+            continue;
+        }
+        const uchar* body = at(position) + sizeof(header);
+        const uint64_t bytes = recordBytes(header.bodyLength);
+        if (header.magic != RECORD_MAGIC || bytes > room || position + bytes > head
+            || header.topicLength + header.hashLength > header.bodyLength
+            || checksumOf(header, body) != header.checksum) {
+            break;
+        }
+        const QByteArray topic(reinterpret_cast<const char*>(body), header.topicLength);
+        m_index[topic].emplace(header.timestampNs, position);
+        ++m_messages;
+        position += bytes;
+    }
+    // A torn record ends the history; the next append overwrites it
+    m_header->head = position;
+}
+
+bool ReceivedStore::evictOldest()
+{
+    const uint64_t tail = m_header->tail;
+    if (tail == m_header->head) {
+        return false;
+    }
+    const uint64_t room = m_capacity - tail % m_capacity;
+    RecordHeader header{};
+    if (room >= sizeof(header)) {
+        std::memcpy(&header, at(tail), sizeof(header));
+    }
+    if (header.magic != RECORD_MAGIC) {
+        m_header->tail = tail + room;
+        return true;
+    }
+
+    const char* body = reinterpret_cast<const char*>(at(tail) + sizeof(header));
+    const auto topic = m_index.find(QByteArray::fromRawData(body, header.topicLength));
+    if (topic != m_index.end()) {
+        topic->erase({header.timestampNs, tail});
+        if (topic->empty()) {
+            m_index.erase(topic);
+        }
+    }
+    --m_messages;
+    ++m_counters.evicted;
+    m_header->tail = tail + recordBytes(header.bodyLength);
+    return true;
+}
+
+void ReceivedStore::evictExpired(int64_t now)
+{
+    if (m_config.maxAge.count() <= 0) {
+        return;
+    }
+    const int64_t cutoff = now - m_config.maxAge.count();
+    while (m_header->tail < m_header->head) {
+        const uint64_t tail = m_header->tail;
+        RecordHeader header{};
+        if (m_capacity - tail % m_capacity >= sizeof(header)) {
+            std::memcpy(&header, at(tail), sizeof(header));
+        }
+        if (header.magic == RECORD_MAGIC && header.storedAtMs >= cutoff) {
+            break;
+        }
+        evictOldest();
+    }
+}
+
+void ReceivedStore::append(std::string_view contentTopic, std::string_view messageHash, std::string_view payload,
+    int64_t timestampNs)
+{
+    if (!enabled()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint64_t bodyLength = contentTopic.size() + messageHash.size() + payload.size();
+    const uint64_t bytes = recordBytes(bodyLength);
+    if (!m_map || bytes > m_capacity / 4 || contentTopic.size() > UINT16_MAX || messageHash.size() > UINT16_MAX) {
+        ++m_counters.rejected;
+        return;
+    }
+
+    const int64_t now = nowMs();
+    evictExpired(now);
+
+    // Records never straddle the end of the ring
+    const uint64_t head = m_header->head;
+    const uint64_t room = m_capacity - head % m_capacity;
+    const uint64_t position = bytes > room ? head + room : head;
+    while (position + bytes - m_header->tail > m_capacity && evictOldest()) {
+    }
+    if (position != head && room >= sizeof(RecordHeader)) {
+        std::memcpy(at(head), &WRAP_MAGIC, sizeof(WRAP_MAGIC));
+    }
+
+    uchar* record = at(position);
+    uchar* body = record + sizeof(RecordHeader);
+    uchar* out = body;
+    for (std::string_view part : {contentTopic, messageHash, payload}) {
+        if (!part.empty()) {
+            std::memcpy(out, part.data(), part.size());
+            out += part.size();
+        }
+    }
+    RecordHeader header{0, static_cast<uint32_t>(bodyLength), timestampNs, now, 0,
+        static_cast<uint16_t>(contentTopic.size()), static_cast<uint16_t>(messageHash.size())};
+    header.checksum = checksumOf(header, body);
+    std::memcpy(record, &header, sizeof(header));
+    // The marker goes last so a partially written record is never taken as valid
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(record, &RECORD_MAGIC, sizeof(RECORD_MAGIC));
+    m_header->head = position + bytes;
+
+    m_index[QByteArray(contentTopic.data(), static_cast<qsizetype>(contentTopic.size()))].emplace(timestampNs, position);
+    ++m_messages;
+    ++m_counters.stored;
+}
+
+std::vector<ReceivedStore::Message> ReceivedStore::query(std::string_view contentTopic, int64_t sinceNs, size_t limit)
+{
+    std::vector<Message> messages;
+    if (!enabled()) {
+        return messages;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_counters.queries;
+    if (!m_map) {
+        return messages;
+    }
+    evictExpired(nowMs());
+
+    const auto topic = m_index.constFind(
+        QByteArray::fromRawData(contentTopic.data(), static_cast<qsizetype>(contentTopic.size())));
+    if (topic == m_index.constEnd()) {
+        return messages;
+    }
+    for (auto it = topic->lower_bound({sinceNs, 0}); it != topic->end() && (limit == 0 || messages.size() < limit); ++it) {
+        RecordHeader header;
+        std::memcpy(&header, at(it->second), sizeof(header));
+        const char* body = reinterpret_cast<const char*>(at(it->second) + sizeof(header));
+        const qsizetype payloadLength = header.bodyLength - header.topicLength - header.hashLength;
+        messages.push_back(Message{QByteArray(body, header.topicLength),
+            QByteArray(body + header.topicLength, header.hashLength),
+            QByteArray(body + header.topicLength + header.hashLength, payloadLength), header.timestampNs});
+    }
+    return messages;
+}
+
+ReceivedStore::Stats ReceivedStore::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats snapshot = m_counters;
+    snapshot.enabled = enabled();
+    if (m_header) {
+        snapshot.capacityBytes = m_capacity;
+        snapshot.usedBytes = m_header->head - m_header->tail;
+    }
+    snapshot.messages = m_messages;
+    snapshot.topics = static_cast<size_t>(m_index.size());
+    return snapshot;
+}
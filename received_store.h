@@ -0,0 +1,112 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "QExpected.h"
+
+/**
+ * @brief Bounded on-disk history of received messages, queried by content topic.
+ *
+ * Messages are appended to a memory-mapped ring log; when the ring is full or
+ * a message is older than the configured age, the oldest messages are
+ * overwritten. Each content topic keeps an in-memory index ordered by message
+ * timestamp, so @ref query is a lookup followed by reads from the mapping.
+ *
+ * The ring's head and tail live in the file header and the index is rebuilt
+ * on @ref open, so history survives restarts. Records carry a checksum; a
+ * record torn by a crash ends the recovered history.
+ */
+class ReceivedStore {
+public:
+    struct Config {
+        QString path;
+        uint64_t capacityBytes{64u << 20};
+        std::chrono::milliseconds maxAge{0}; ///< `0` keeps messages until their space is needed.
+    };
+
+    struct Message {
+        QByteArray contentTopic;
+        QByteArray messageHash;
+        QByteArray payload;
+        int64_t timestampNs{0};
+    };
+
+    struct Stats {
+        bool enabled{false};
+        uint64_t capacityBytes{0};
+        uint64_t usedBytes{0};
+        size_t messages{0};
+        size_t topics{0};
+        uint64_t stored{0};
+        uint64_t evicted{0};
+        uint64_t rejected{0};
+        uint64_t queries{0};
+    };
+
+    ReceivedStore() = default;
+    ~ReceivedStore();
+
+    ReceivedStore(const ReceivedStore&) = delete;
+    ReceivedStore& operator=(const ReceivedStore&) = delete;
+
+    /**
+     * @brief Opens or creates the store at `config.path` and indexes its history.
+     *
+     * A store written with another capacity is discarded. A store that is
+     * already open is closed first.
+     */
+    QExpected<void> open(const Config& config);
+
+    void close();
+
+    bool enabled() const { return m_enabled.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Stores a received message, evicting the oldest ones as needed.
+     *
+     * Messages larger than a quarter of the ring are counted as `rejected`.
+     */
+    void append(std::string_view contentTopic, std::string_view messageHash, std::string_view payload,
+        int64_t timestampNs);
+
+    /**
+     * @brief Messages on @p contentTopic with a timestamp of at least @p sinceNs, oldest first.
+     * @param limit Most messages returned; `0` returns all of them.
+     */
+    std::vector<Message> query(std::string_view contentTopic, int64_t sinceNs, size_t limit);
+
+    Stats stats() const;
+
+private:
+    struct FileHeader;
+    using TopicIndex = std::set<std::pair<int64_t, uint64_t>>; // (timestampNs, position)
+
+    // Callers hold m_mutex
+    uchar* at(uint64_t position) const;
+    bool evictOldest();
+    void evictExpired(int64_t nowMs);
+    void recover();
+
+    Config m_config;
+    std::atomic<bool> m_enabled{false};
+
+    mutable std::mutex m_mutex;
+    QFile m_file;
+    uchar* m_map{nullptr};
+    FileHeader* m_header{nullptr};
+    uchar* m_data{nullptr};
+    uint64_t m_capacity{0};
+    QHash<QByteArray, TopicIndex> m_index;
+    size_t m_messages{0};
+    Stats m_counters;
+};
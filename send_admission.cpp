@@ -0,0 +1,109 @@
+#include "send_admission.h"
+
+#include <algorithm>
+
+void SendAdmission::setLimits(Limits limits)
+{
+    m_limitPerNode.store(limits.perNode, std::memory_order_relaxed);
+    m_limitPerTopic.store(limits.perTopic, std::memory_order_relaxed);
+}
+
+bool SendAdmission::enabled() const
+{
+    return m_limitPerNode.load(std::memory_order_relaxed) > 0
+        || m_limitPerTopic.load(std::memory_order_relaxed) > 0;
+}
+
+uint64_t SendAdmission::topicKey(std::string_view contentTopic)
+{
+    // FNV-1a; 64 bits make collisions between live topics negligible
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : contentTopic) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+std::chrono::milliseconds SendAdmission::retryAfter(uint32_t inflight) const
+{
+    const auto average = std::chrono::nanoseconds(m_averageCompletionNs.load(std::memory_order_relaxed));
+    const auto perSlot = std::chrono::duration_cast<std::chrono::milliseconds>(average / std::max<uint32_t>(inflight, 1));
+    return std::clamp(perSlot, kMinRetryAfter, kMaxRetryAfter);
+}
+
+SendAdmission::Decision SendAdmission::tryAcquire(uint64_t topic)
+{
+    Decision decision;
+    const uint32_t nodeLimit = m_limitPerNode.load(std::memory_order_relaxed);
+    uint32_t inflight = m_inflight.load(std::memory_order_relaxed);
+    do {
+        if (nodeLimit > 0 && inflight >= nodeLimit) {
+            m_rejectedNode.fetch_add(1, std::memory_order_relaxed);
+            decision.admitted = false;
+            decision.scope = Scope::Node;
+            decision.inflight = inflight;
+            decision.limit = nodeLimit;
+            decision.retryAfter = retryAfter(inflight);
+            return decision;
+        }
+    } while (!m_inflight.compare_exchange_weak(inflight, inflight + 1, std::memory_order_relaxed));
+
+    const uint32_t topicLimit = m_limitPerTopic.load(std::memory_order_relaxed);
+    if (topicLimit > 0) {
+        std::lock_guard<std::mutex> lock(m_topicMutex);
+        const auto it = m_topicInflight.find(topic);
+        if (it != m_topicInflight.end() && it->second >= topicLimit) {
+            m_inflight.fetch_sub(1, std::memory_order_relaxed);
+            m_rejectedTopic.fetch_add(1, std::memory_order_relaxed);
+            decision.admitted = false;
+            decision.scope = Scope::Topic;
+            decision.inflight = it->second;
+            decision.limit = topicLimit;
+            decision.retryAfter = retryAfter(it->second);
+            return decision;
+        }
+        if (it != m_topicInflight.end()) {
+            ++it->second;
+        } else {
+            m_topicInflight.emplace(topic, 1);
+            m_trackedTopics.store(m_topicInflight.size(), std::memory_order_relaxed);
+        }
+    }
+
+    m_admitted.fetch_add(1, std::memory_order_relaxed);
+    return decision;
+}
+
+void SendAdmission::release(uint64_t topic, Clock::duration age)
+{
+    m_inflight.fetch_sub(1, std::memory_order_relaxed);
+
+    // Without a per-topic cap the map stays empty and the lock is skipped
+    if (m_trackedTopics.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(m_topicMutex);
+        const auto it = m_topicInflight.find(topic);
+        if (it != m_topicInflight.end() && --it->second == 0) {
+            m_topicInflight.erase(it);
+            m_trackedTopics.store(m_topicInflight.size(), std::memory_order_relaxed);
+        }
+    }
+
+    const int64_t ageNs = std::chrono::duration_cast<std::chrono::nanoseconds>(age).count();
+    if (ageNs > 0) {
+        // Exponential moving average with weight 1/8; races only lose an update
+        const int64_t average = m_averageCompletionNs.load(std::memory_order_relaxed);
+        m_averageCompletionNs.store(average + (ageNs - average) / 8, std::memory_order_relaxed);
+    }
+}
+
+SendAdmission::Stats SendAdmission::stats() const
+{
+    Stats snapshot;
+    snapshot.limits.perNode = m_limitPerNode.load(std::memory_order_relaxed);
+    snapshot.limits.perTopic = m_limitPerTopic.load(std::memory_order_relaxed);
+    snapshot.inflight = m_inflight.load(std::memory_order_relaxed);
+    snapshot.admitted = m_admitted.load(std::memory_order_relaxed);
+    snapshot.rejectedNode = m_rejectedNode.load(std::memory_order_relaxed);
+    snapshot.rejectedTopic = m_rejectedTopic.load(std::memory_order_relaxed);
+    return snapshot;
+}
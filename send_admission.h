@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Caps the number of sends in flight, per node and optionally per content topic.
+ *
+ * A send is admitted before its FFI call and stays counted until it reaches a
+ * terminal delivery event, fails, or expires from the in-flight table. When a
+ * cap is reached, @ref tryAcquire refuses immediately and suggests when to
+ * retry: with `n` sends in flight that each take `t` on average, a slot frees
+ * up about every `t / n`.
+ *
+ * The per-node count is a single atomic. Per-topic counts, kept only when a
+ * per-topic cap is configured, live in a small map under a mutex; it holds
+ * one entry per topic that currently has sends in flight.
+ */
+class SendAdmission {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Caps; `0` means unlimited.
+     */
+    struct Limits {
+        uint32_t perNode{0};
+        uint32_t perTopic{0};
+    };
+
+    /**
+     * @brief Which cap refused a send.
+     */
+    enum class Scope : uint8_t { Node, Topic };
+
+    struct Decision {
+        bool admitted{true};
+        Scope scope{Scope::Node};
+        uint32_t inflight{0};
+        uint32_t limit{0};
+        std::chrono::milliseconds retryAfter{0};
+    };
+
+    struct Stats {
+        Limits limits;
+        uint32_t inflight{0};
+        uint64_t admitted{0};
+        uint64_t rejectedNode{0};
+        uint64_t rejectedTopic{0};
+    };
+
+    /**
+     * @brief Replaces the caps; sends already in flight stay counted.
+     */
+    void setLimits(Limits limits);
+
+    /**
+     * @brief `true` when any cap is configured; otherwise nothing needs acquiring.
+     */
+    bool enabled() const;
+
+    /**
+     * @brief Key identifying @p contentTopic in @ref tryAcquire and @ref release.
+     */
+    static uint64_t topicKey(std::string_view contentTopic);
+
+    /**
+     * @brief Counts one more send for the node and @p topic unless a cap is reached.
+     */
+    Decision tryAcquire(uint64_t topic);
+
+    /**
+     * @brief Releases a send admitted by @ref tryAcquire.
+     * @param age How long the send was in flight; a zero age does not feed the retry estimate.
+     */
+    void release(uint64_t topic, Clock::duration age);
+
+    Stats stats() const;
+
+private:
+    static constexpr std::chrono::milliseconds kMinRetryAfter{10};
+    static constexpr std::chrono::milliseconds kMaxRetryAfter{5000};
+    static constexpr std::chrono::milliseconds kInitialCompletionEstimate{1000};
+
+    std::chrono::milliseconds retryAfter(uint32_t inflight) const;
+
+    std::atomic<uint32_t> m_limitPerNode{0};
+    std::atomic<uint32_t> m_limitPerTopic{0};
+    std::atomic<uint32_t> m_inflight{0};
+    std::atomic<int64_t> m_averageCompletionNs{
+        std::chrono::duration_cast<std::chrono::nanoseconds>(kInitialCompletionEstimate).count()};
+
+    std::atomic<uint64_t> m_admitted{0};
+    std::atomic<uint64_t> m_rejectedNode{0};
+    std::atomic<uint64_t> m_rejectedTopic{0};
+
+    mutable std::mutex m_topicMutex;
+    std::unordered_map<uint64_t, uint32_t> m_topicInflight;
+    std::atomic<size_t> m_trackedTopics{0};
+};
@@ -0,0 +1,78 @@
+#include "topic_router.h"
+
+#include <mutex>
+
+bool TopicRouter::add(std::string_view contentTopic, const QString& clientName)
+{
+    std::unique_lock lock(m_mutex);
+    auto it = m_topicIds.find(contentTopic);
+    if (it == m_topicIds.end()) {
+        uint32_t id;
+        if (!m_freeIds.empty()) {
+            id = m_freeIds.back();
+            m_freeIds.pop_back();
+        } else {
+            id = static_cast<uint32_t>(m_routes.size());
+            m_routes.emplace_back();
+        }
+        it = m_topicIds.emplace(std::string(contentTopic), id).first;
+        m_topicCount.store(m_topicIds.size(), std::memory_order_relaxed);
+    }
+
+    QStringList& clients = m_routes[it->second];
+    if (clients.contains(clientName)) {
+        return false;
+    }
+    clients.append(clientName);
+    ++m_routeCount;
+    return true;
+}
+
+bool TopicRouter::remove(std::string_view contentTopic, const QString& clientName)
+{
+    std::unique_lock lock(m_mutex);
+    const auto it = m_topicIds.find(contentTopic);
+    if (it == m_topicIds.end()) {
+        return false;
+    }
+
+    QStringList& clients = m_routes[it->second];
+    if (!clients.removeOne(clientName)) {
+        return false;
+    }
+    --m_routeCount;
+    if (clients.isEmpty()) {
+        m_freeIds.push_back(it->second);
+        m_topicIds.erase(it);
+        m_topicCount.store(m_topicIds.size(), std::memory_order_relaxed);
+    }
+    return true;
+}
+
+QStringList TopicRouter::clientsFor(std::string_view contentTopic) const
+{
+    if (m_topicCount.load(std::memory_order_relaxed) == 0) {
+        m_unrouted.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+
+    std::shared_lock lock(m_mutex);
+    const auto it = m_topicIds.find(contentTopic);
+    if (it == m_topicIds.end()) {
+        m_unrouted.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+    m_routed.fetch_add(1, std::memory_order_relaxed);
+    return m_routes[it->second];
+}
+
+TopicRouter::Stats TopicRouter::stats() const
+{
+    std::shared_lock lock(m_mutex);
+    Stats snapshot;
+    snapshot.topics = m_topicIds.size();
+    snapshot.routes = m_routeCount;
+    snapshot.routed = m_routed.load(std::memory_order_relaxed);
+    snapshot.unrouted = m_unrouted.load(std::memory_order_relaxed);
+    return snapshot;
+}
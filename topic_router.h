@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Maps content topics to the Logos API clients that asked for them.
+ *
+ * Topics are interned once into small ids that index the route lists, so
+ * resolving a received message is one hash lookup on the raw UTF-8 topic
+ * without building a QString. The returned QStringList is implicitly shared,
+ * so handing it to the dispatcher copies no strings.
+ *
+ * Lookups take a shared lock and registrations an exclusive one; while no
+ * route exists at all lookups return immediately without locking.
+ */
+class TopicRouter {
+public:
+    struct Stats {
+        size_t topics{0};
+        size_t routes{0};
+        uint64_t routed{0};
+        uint64_t unrouted{0};
+    };
+
+    /**
+     * @brief Routes @p contentTopic to @p clientName as well.
+     * @return `false` if that route already existed.
+     */
+    bool add(std::string_view contentTopic, const QString& clientName);
+
+    /**
+     * @brief Stops routing @p contentTopic to @p clientName.
+     * @return `false` if there was no such route.
+     */
+    bool remove(std::string_view contentTopic, const QString& clientName);
+
+    /**
+     * @brief Clients registered for @p contentTopic; empty when the topic has no route.
+     */
+    QStringList clientsFor(std::string_view contentTopic) const;
+
+    Stats stats() const;
+
+private:
+    struct TopicHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view topic) const { return std::hash<std::string_view>{}(topic); }
+    };
+
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<std::string, uint32_t, TopicHash, std::equal_to<>> m_topicIds;
+    std::vector<QStringList> m_routes; // indexed by topic id
+    std::vector<uint32_t> m_freeIds;
+    size_t m_routeCount{0};
+
+    std::atomic<size_t> m_topicCount{0};
+    mutable std::atomic<uint64_t> m_routed{0};
+    mutable std::atomic<uint64_t> m_unrouted{0};
+};